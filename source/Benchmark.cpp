@@ -0,0 +1,190 @@
+#include "Benchmark.hpp"
+#include "project_utility.hpp"
+#include "project_print.hpp"
+#include "PixelKernel.hpp"
+#include "KernelBackend.hpp"
+#include "InputTrace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Project::Benchmark {
+    /**
+     * @brief Compute the FNV-1a hash of a pixel buffer, so that runs can be checked to render the same frames.
+     */
+    static std::uint64_t hashPixels(std::vector<Uint32> const &pixelBuffer) {
+        std::uint64_t hash{0xCBF29CE484222325u};
+        for (Uint32 const pixel : pixelBuffer) {
+            hash ^= pixel;
+            hash *= 0x100000001B3u;
+        }
+        return hash;
+    }
+
+    /**
+     * @param sortedList ascending list of samples, which is not empty
+     * @param percentage in range [0, 1]
+     */
+    static std::int64_t percentile(std::vector<std::int64_t> const &sortedList, double const percentage) {
+        assert(not sortedList.empty());
+        auto const index{static_cast<std::size_t>(std::round(percentage * static_cast<double>(sortedList.size() - 1u)))};
+        return sortedList[index];
+    }
+
+    /**
+     * @brief Print the frame rate, the time per pixel, and percentiles of the frame time.
+     * 
+     * @param frameTimeList time of every frame in nanoseconds, which is not empty
+     * @param pixelCount mean number of pixels of a frame
+     */
+    static void printFrameTimes(std::vector<std::int64_t> frameTimeList, double const pixelCount) {
+        std::int64_t totalTime{0};
+        for (auto const frameTime : frameTimeList) totalTime += frameTime;
+        std::sort(frameTimeList.begin(), frameTimeList.end());
+
+        double const meanFrameTime{static_cast<double>(totalTime) / static_cast<double>(frameTimeList.size())};
+
+        println("Frames per second: ", 1.0e9 / meanFrameTime);
+        println("Nanoseconds per pixel: ", meanFrameTime / pixelCount);
+        println("Frame time in microseconds: ",
+            "min=", static_cast<double>(frameTimeList.front()) / 1.0e3, ' ',
+            "p50=", static_cast<double>(percentile(frameTimeList, 0.50)) / 1.0e3, ' ',
+            "p90=", static_cast<double>(percentile(frameTimeList, 0.90)) / 1.0e3, ' ',
+            "p99=", static_cast<double>(percentile(frameTimeList, 0.99)) / 1.0e3, ' ',
+            "max=", static_cast<double>(frameTimeList.back()) / 1.0e3
+        );
+    }
+}
+
+int Project::Benchmark::run(int const frameCount, Uint64 const simulatedDeltaTime) {
+    namespace Sdl = SdlContext;
+
+    if (frameCount <= 0) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "The frame count must be positive.");
+        return EXIT_FAILURE;
+    }
+
+    // A common texture format, so that the pixel hash is the same on every machine.
+    Sdl::pixelFormat = Sdl::check(SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888));
+
+    int const pixelCount{Sdl::getCanvasBufferWidth() * Sdl::getCanvasBufferHeight()};
+    int const pitch{Sdl::getCanvasBufferWidth() * static_cast<int>(sizeof(Uint32))};
+    std::vector<Uint32> pixelBuffer(static_cast<std::size_t>(pixelCount));
+
+    Sdl::setDeltaTime(simulatedDeltaTime);
+
+    // Warm up the caches and the branch predictors.
+    static constexpr int warmUpFrameCount{8};
+    for (int frame{0}; frame < warmUpFrameCount; ++frame) {
+        Sdl::updateAnimation();
+        Sdl::renderCanvas(pixelBuffer.data(), pitch);
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    long long const warmUpFieldUpdateCount{Sdl::getFieldUpdateCount()};
+
+    std::vector<std::int64_t> frameTimeList(static_cast<std::size_t>(frameCount));
+    for (auto &frameTime : frameTimeList) {
+        Sdl::updateAnimation();
+        auto const startTime{Clock::now()};
+        Sdl::renderCanvas(pixelBuffer.data(), pitch);
+        frameTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count();
+    }
+
+    println("Canvas: ", Sdl::getCanvasBufferWidth(), 'x', Sdl::getCanvasBufferHeight());
+    println("Kernel backend: ", KernelBackend::getSelected().name, " (", KernelBackend::getSelected().key, ')');
+    println("Threads: ", Sdl::getThreadCount());
+    println("Frames: ", frameCount, " (simulated delta time ", simulatedDeltaTime, " ms)");
+    printFrameTimes(frameTimeList, pixelCount);
+    println("Last frame hash: ", std::hex, hashPixels(pixelBuffer), std::dec);
+    println("Hue field recomputed: ", Sdl::getFieldUpdateCount() - warmUpFieldUpdateCount, " of ", frameCount, " frames");
+
+    if (Sdl::isKernelVerificationEnabled()) println(
+        "Largest channel difference from the ", KernelBackend::getReference().name, " reference: ", Sdl::getLargestKernelDifference()
+    );
+
+    return EXIT_SUCCESS;
+}
+
+int Project::Benchmark::replay(std::string const &path, bool const isWindowed) {
+    namespace Sdl = SdlContext;
+
+    std::optional<InputTrace::Trace> const trace{InputTrace::load(path)};
+    if (not trace.has_value()) return EXIT_FAILURE;
+
+    if (not isWindowed) {
+        // A common texture format, so that the pixel hashes are the same on every machine.
+        Sdl::pixelFormat = Sdl::check(SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888));
+    } else if (Sdl::isPipelineEnabled()) {
+        // The render thread finishes frames whenever it can, so the frames on the window would depend on timing.
+        Sdl::warn("Replaying without the pipeline, so that every frame is rendered from its own input.");
+        Sdl::setPipelineEnabled(false);
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    long long const firstFieldUpdateCount{Sdl::getFieldUpdateCount()};
+
+    std::vector<Uint32> pixelBuffer;
+    std::vector<std::int64_t> frameTimeList;
+    frameTimeList.reserve(trace->frameList.size());
+    double totalPixelCount{0.0};
+
+    // Hash of the hashes of every frame, in order.
+    std::uint64_t traceHash{0xCBF29CE484222325u};
+
+    for (InputTrace::Frame const &frame : trace->frameList) {
+        // With adaptive resolution, the canvas buffer adapts to how long this machine took to render the previous frame.
+        if (not frameTimeList.empty()) Sdl::setBusyFrameTime(static_cast<double>(frameTimeList.back()) / 1.0e6);
+        if (not Sdl::replayInput(frame.time, frame.eventList.data(), frame.eventList.size())) continue;
+
+        // With adaptive resolution, the canvas buffer may have been resized by the input of this iteration.
+        int const width{Sdl::getCanvasBufferWidth()}, height{Sdl::getCanvasBufferHeight()};
+        totalPixelCount += static_cast<double>(width) * static_cast<double>(height);
+
+        if (isWindowed) {
+            auto const startTime{Clock::now()};
+            Sdl::refreshWindow();
+            frameTimeList.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count());
+
+            // The replayed input stands in for the window's own input, except that closing the window stops the replay.
+            SDL_Event event;
+            bool isQuitting{false};
+            while (SDL_PollEvent(&event)) isQuitting = isQuitting or event.type == SDL_QUIT;
+            if (isQuitting) break;
+        } else {
+            pixelBuffer.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+            Sdl::updateAnimation();
+            auto const startTime{Clock::now()};
+            Sdl::renderCanvas(pixelBuffer.data(), width * static_cast<int>(sizeof(Uint32)));
+            frameTimeList.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count());
+
+            traceHash ^= hashPixels(pixelBuffer);
+            traceHash *= 0x100000001B3u;
+        }
+    }
+
+    if (frameTimeList.empty()) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "The input trace \"%s\" does not render any frame.", path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    println("Trace: ", path, " (", trace->frameList.size(), " iterations over ", static_cast<double>(trace->getDuration()) / 1000.0, " seconds)");
+    println("Canvas: ", Sdl::getCanvasBufferWidth(), 'x', Sdl::getCanvasBufferHeight());
+    println("Kernel backend: ", KernelBackend::getSelected().name, " (", KernelBackend::getSelected().key, ')');
+    println("Threads: ", Sdl::getThreadCount());
+    println("Frames: ", frameTimeList.size(), isWindowed ? " (presented to the window)" : "");
+    printFrameTimes(frameTimeList, totalPixelCount / static_cast<double>(frameTimeList.size()));
+    if (not isWindowed) {
+        println("Last frame hash: ", std::hex, hashPixels(pixelBuffer), std::dec);
+        println("Trace hash: ", std::hex, traceHash, std::dec);
+    }
+    println("Hue field recomputed: ", Sdl::getFieldUpdateCount() - firstFieldUpdateCount, " of ", frameTimeList.size(), " frames");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+#ifndef Benchmark_hpp
+#define Benchmark_hpp true
+
+#include <string>
+#include "SdlContext.hpp"
+
+namespace Project::Benchmark {
+    /**
+     * @brief Render frames of the canvas into a CPU pixel buffer, then print timing statistics.
+     * 
+     * @note This function does not create a window nor a renderer, so it works without a display.
+     * The clock is simulated, so every run renders the same sequence of frames.
+     * 
+     * @param frameCount number of frames to time
+     * @param simulatedDeltaTime milliseconds that the simulated clock advances each frame
+     * @return exit status for `main`
+     */
+    extern int run(int const frameCount, Uint64 const simulatedDeltaTime=16u);
+
+    /**
+     * @brief Replay an input trace on its recorded clock, rendering the frame of every iteration, then print timing statistics.
+     * 
+     * @note The frames depend only on the trace and the options that change the picture, not on how fast they are rendered,
+     * so the same trace and options render the same frames on every run. Without a window, frames are rendered into a CPU pixel buffer,
+     * like `run`, and a hash of every frame is printed. With a window, which must exist, frames are presented like the main loop does,
+     * but without waiting between them.
+     * 
+     * @param path file written with `InputTrace::startRecording`
+     * @param isWindowed whether to present the frames to the window
+     * @return exit status for `main`
+     */
+    extern int replay(std::string const &path, bool const isWindowed);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include "CanvasRenderer.hpp"
+
+#include <algorithm>
+
+void Project::CanvasRenderer::render(
+    FrameState const &state,
+    SDL_PixelFormat const &format,
+    void *const pixelPointer,
+    int const pitch,
+    WorkerPool *const workerPool
+) {
+    // Rows are `pitch` bytes apart, which need not be a whole number of pixels.
+    Uint8 *const pixelBytes{static_cast<Uint8 *>(pixelPointer)};
+
+    hueTable.update(state.color.getSaturation(), state.color.getLuminance(), state.color.getAlpha(), format);
+
+    // Only the base hue changes for every pixel in every frame; the spatial field is recomputed when the points move enough.
+    bool const fieldIsStale{hueField.setInputs(
+        state.pointList, state.hueScale, state.fieldReuseDistance, state.fieldStride, state.fieldTolerance
+    )};
+    if (fieldIsStale) ++fieldUpdateCount;
+    HueField::Phase const baseHue{HueField::toPhase(state.color.getHuePhase())};
+
+    // Split the width into as few tiles as possible, of about the same number of cells each.
+    int const width{hueField.getWidth()};
+    int const tileCount{(width + maxColumnsPerTile - 1) / maxColumnsPerTile};
+    int const cellsPerTile{((width + HueField::cellSize - 1) / HueField::cellSize + tileCount - 1) / tileCount};
+    int const tileWidth{fieldIsStale ? cellsPerTile * HueField::cellSize : width};
+    int const bytesPerPixel{format.BytesPerPixel};
+
+    auto const renderRows = [=](int const beginRow, int const endRow) -> void {
+        // Rows that every thread computes its tiles in, kept between frames so that they are allocated once and stay warm.
+        thread_local HueField::Scratch scratch;
+
+        for (int beginColumn{0}; beginColumn < width; beginColumn += tileWidth) {
+            int const endColumn{std::min(width, beginColumn + tileWidth)};
+            if (fieldIsStale) hueField.computeRows(beginRow, endRow, beginColumn, endColumn, scratch);
+
+            for (int y{beginRow}; y < endRow; ++y) hueTable.convertRow(
+                hueField.getRow(y) + beginColumn,
+                pixelBytes + static_cast<std::ptrdiff_t>(y)/* row */ * pitch + static_cast<std::ptrdiff_t>(beginColumn) * bytesPerPixel,
+                endColumn - beginColumn,
+                baseHue
+            );
+        }
+    };
+
+    if (workerPool == nullptr) renderRows(0, hueField.getHeight());
+    else workerPool->run(hueField.getHeight(), rowsPerBand, renderRows);
+}
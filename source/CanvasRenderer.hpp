@@ -0,0 +1,119 @@
+#ifndef CanvasRenderer_hpp
+#define CanvasRenderer_hpp true
+
+#include "SdlContext.hpp"
+#include "HslaColor.hpp"
+#include "HueField.hpp"
+#include "PixelKernel.hpp"
+#include "WorkerPool.hpp"
+
+namespace Project {
+  /**
+   * @brief Everything that a frame of the canvas is a pure function of.
+   */
+  struct FrameState {
+    // Color of a pixel that no point contributes to.
+    HslaColor color;
+
+    // Hue in degrees per pixel of weighted distance.
+    float hueScale{0.0f};
+
+    // Sinks and sources, in pixels of the canvas buffer.
+    HueField::PointList pointList;
+
+    /*
+      Farthest distance in pixels that a point may move before the spatial hue field of the previous frame is recomputed.
+      At zero, the field is reused only when nothing but the base hue changed, so the frame is exact.
+    */
+    float fieldReuseDistance{0.0f};
+
+    /*
+      Side in pixels of the blocks of the canvas that share one computed hue. Above 1, the frame is a coarse preview,
+      which the spatial hue field of a later frame with a smaller stride refines.
+    */
+    int fieldStride{1};
+
+    /*
+      Largest error in degrees of hue that interpolating the spatial hue field inside the cells of a coarse grid may make,
+      when there are many points. At zero, every pixel is computed.
+    */
+    float fieldTolerance{0.0f};
+  };
+
+  class CanvasRenderer;
+}
+
+/**
+ * @brief Turns a frame state into the pixels of a canvas.
+ * 
+ * @note A renderer keeps the buffers of the intermediate stages,
+ * so frames that are rendered at the same time need a renderer each.
+ */
+class Project::CanvasRenderer {
+  public:
+    /**
+     * @param backend kernel backend to render with, or null for `KernelBackend::getSelected()`
+     */
+    CanvasRenderer(int const width, int const height, KernelBackend::Table const *const backend=nullptr): hueField(width, height) {
+      hueField.setBackend(backend);
+      hueTable.setBackend(backend);
+    }
+
+    void resize(int const width, int const height) { hueField.resize(width, height); }
+
+    int getWidth() const { return hueField.getWidth(); }
+    int getHeight() const { return hueField.getHeight(); }
+
+    /**
+     * @return number of frames rendered so far whose spatial hue field was recomputed instead of reused
+     */
+    long long getFieldUpdateCount() const { return fieldUpdateCount; }
+
+    /**
+     * @brief Render a frame into a pixel buffer.
+     * 
+     * @note Not thread-safe.
+     * 
+     * @param state frame to render
+     * @param format layout of the pixels; must be supported by `PixelKernel::HueTable`
+     * @param pixelPointer first pixel of the buffer
+     * @param pitch length of a row of the buffer in bytes
+     * @param workerPool threads to render bands of rows with, or null to render on the calling thread
+     * 
+     * @note Each band is computed and converted one tile of columns at a time, so that a canvas of any width
+     * costs the same per pixel, until the field and the pixels themselves no longer fit in the caches.
+     */
+    void render(
+      FrameState const &state,
+      SDL_PixelFormat const &format,
+      void *const pixelPointer,
+      int const pitch,
+      WorkerPool *const workerPool
+    );
+
+  private:
+    /*
+      Number of rows in a band that one thread renders at a time.
+      A multiple of the field strides and of the cell size of the field, so that bands share no blocks nor cells.
+    */
+    static constexpr int rowsPerBand{8};
+    static_assert(rowsPerBand % HueField::cellSize == 0);
+
+    /*
+      Most columns in a tile, which bands of wide canvases are split into evenly. A tile's phases, pixels, and scratch row
+      (8 by 512 pixels: 8 KiB, 16 KiB, and 2 KiB) fit in the L1 cache, so converting a tile reads phases that were just computed.
+      Tiles start at multiples of the cell size, so that they share no blocks nor cells either.
+    */
+    static constexpr int maxColumnsPerTile{512};
+    static_assert(maxColumnsPerTile % HueField::cellSize == 0);
+
+    // Hue of every pixel of the canvas, without the base hue. Kept between frames.
+    HueField hueField;
+
+    long long fieldUpdateCount{0};
+
+    // Pixel of every hue step, for the saturation, luminance, and alpha of the frame's color.
+    PixelKernel::HueTable hueTable;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "Exporter.hpp"
+#include "CanvasRenderer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace Project::Exporter {
+    enum struct Format : std::uint_least8_t { y4m, ppm, };
+
+    // Largest number of bytes that the hue fields and the pixel and encoded buffers of the frames in flight may take together.
+    static constexpr std::size_t slotMemoryBudget{std::size_t{1} << 30u};
+
+    /**
+     * @brief Convert a frame of ARGB8888 pixels to the bytes of one frame in the output format.
+     */
+    static void encodeFrame(Format const format, std::vector<Uint32> const &pixelList, int const width, int const height, std::string &output) {
+        std::size_t const pixelCount{pixelList.size()};
+        output.clear();
+
+        switch (format) {
+            case Format::y4m: {
+                output += "FRAME\n";
+                std::size_t const headerSize{output.size()};
+                output.resize(headerSize + 3u * pixelCount);
+                auto *const yPlane = reinterpret_cast<unsigned char *>(output.data() + headerSize);
+                auto *const uPlane = yPlane + pixelCount;
+                auto *const vPlane = uPlane + pixelCount;
+                // BT.601 with studio swing.
+                for (std::size_t index{0u}; index < pixelCount; ++index) {
+                    int const r{static_cast<int>((pixelList[index] >> 16u) & 0xFFu)};
+                    int const g{static_cast<int>((pixelList[index] >> 8u) & 0xFFu)};
+                    int const b{static_cast<int>(pixelList[index] & 0xFFu)};
+                    yPlane[index] = static_cast<unsigned char>((( 66 * r + 129 * g +  25 * b + 128) >> 8) +  16);
+                    uPlane[index] = static_cast<unsigned char>(((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+                    vPlane[index] = static_cast<unsigned char>(((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+                }
+            } break;
+            case Format::ppm: {
+                output += "P6\n" + std::to_string(width) + ' ' + std::to_string(height) + "\n255\n";
+                std::size_t const headerSize{output.size()};
+                output.resize(headerSize + 3u * pixelCount);
+                auto *const rgbList = reinterpret_cast<unsigned char *>(output.data() + headerSize);
+                for (std::size_t index{0u}; index < pixelCount; ++index) {
+                    rgbList[3u * index + 0u] = static_cast<unsigned char>(pixelList[index] >> 16u);
+                    rgbList[3u * index + 1u] = static_cast<unsigned char>(pixelList[index] >> 8u);
+                    rgbList[3u * index + 2u] = static_cast<unsigned char>(pixelList[index]);
+                }
+            } break;
+        }
+    }
+}
+
+int Project::Exporter::run(std::string const &path, double const duration, double const framesPerSecond) {
+    namespace Sdl = SdlContext;
+
+    if (duration <= 0.0 or framesPerSecond <= 0.0) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "The duration and the frame rate must be positive.");
+        return EXIT_FAILURE;
+    }
+
+    bool const isStandardOutput{path == "-"};
+    Format const format{
+        isStandardOutput or (path.size() >= 4u and path.compare(path.size() - 4u, 4u, ".y4m") == 0) ? Format::y4m : Format::ppm
+    };
+
+    std::ofstream file;
+    if (not isStandardOutput) {
+        file.open(path, std::ios::binary);
+        if (not file) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Failed to open \"%s\" for writing.", path.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream &output = isStandardOutput ? std::cout : file;
+
+    int const width{Sdl::getCanvasBufferWidth()}, height{Sdl::getCanvasBufferHeight()};
+    auto const frameCount{static_cast<long long>(duration * framesPerSecond)};
+
+    if (format == Format::y4m) output
+        << "YUV4MPEG2 W" << width << " H" << height
+        << " F" << std::lround(framesPerSecond * 1000.0) << ":1000 Ip A1:1 C444\n";
+
+    // Whatever the texture format of a display, export in one known layout.
+    std::unique_ptr<SDL_PixelFormat, decltype(&SDL_FreeFormat)> const pixelFormat(
+        Sdl::check(SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888)), &SDL_FreeFormat
+    );
+
+    WorkerPool &workerPool = Sdl::getWorkerPool();
+    int const threadCount{workerPool.getThreadCount()};
+
+    /*
+        Each frame in flight takes a hue field, a pixel buffer, and an encoded frame, of about 9 bytes per pixel.
+        Frames are rendered one per thread, up to two per thread, as long as they fit in the memory budget.
+        Otherwise, one frame is rendered at a time, in bands of rows by every thread, so that large canvases do not exhaust memory.
+    */
+    std::size_t const pixelCount{static_cast<std::size_t>(width) * static_cast<std::size_t>(height)};
+    std::size_t const slotSize{pixelCount * (sizeof(HueField::Phase) + sizeof(Uint32) + 3u)};
+    std::size_t const budgetSlotCount{std::min(slotMemoryBudget / slotSize, 2u * static_cast<std::size_t>(threadCount))};
+    bool const isFrameParallel{budgetSlotCount >= static_cast<std::size_t>(threadCount)};
+    int const batchSize{isFrameParallel ? static_cast<int>(budgetSlotCount) : 1};
+    if (not isFrameParallel and threadCount > 1) SDL_LogInfo(
+        SDL_LOG_CATEGORY_APPLICATION, "Frames of %dx%d do not fit in memory one per thread, so each is rendered by every thread.", width, height
+    );
+
+    // A renderer, a frame state, and buffers for each frame of a batch.
+    struct Slot {
+        CanvasRenderer renderer;
+        FrameState state;
+        std::vector<Uint32> pixelList;
+        std::string encodedFrame;
+    };
+    std::vector<Slot> slotList;
+    slotList.reserve(static_cast<std::size_t>(batchSize));
+    for (int index{0}; index < batchSize; ++index) slotList.push_back(Slot{
+        CanvasRenderer(width, height), FrameState(), std::vector<Uint32>(pixelCount), {}
+    });
+
+    for (long long batchStart{0}; batchStart < frameCount; batchStart += batchSize) {
+        int const batchCount{static_cast<int>(std::min<long long>(batchSize, frameCount - batchStart))};
+
+        auto const renderSlot = [&](int const slotIndex, WorkerPool *const rowPool) -> void {
+            Slot &slot = slotList[static_cast<std::size_t>(slotIndex)];
+            double const time{static_cast<double>(batchStart + slotIndex) * 1000.0 / framesPerSecond};
+            Sdl::computeAnimationFrameState(slot.state, time, width, height);
+            slot.renderer.render(
+                slot.state, *pixelFormat, slot.pixelList.data(), width * static_cast<int>(sizeof(Uint32)), rowPool
+            );
+            encodeFrame(format, slot.pixelList, width, height, slot.encodedFrame);
+        };
+
+        if (isFrameParallel) {
+            // Render the frames of the batch in parallel, one frame per band.
+            workerPool.run(batchCount, 1, [&](int const beginSlot, int const endSlot) -> void {
+                for (int slotIndex{beginSlot}; slotIndex < endSlot; ++slotIndex) renderSlot(slotIndex, nullptr);
+            });
+        } else {
+            for (int slotIndex{0}; slotIndex < batchCount; ++slotIndex) renderSlot(slotIndex, &workerPool);
+        }
+
+        // Write the frames in order.
+        for (int slotIndex{0}; slotIndex < batchCount; ++slotIndex) {
+            auto const &encodedFrame = slotList[static_cast<std::size_t>(slotIndex)].encodedFrame;
+            output.write(encodedFrame.data(), static_cast<std::streamsize>(encodedFrame.size()));
+        }
+
+        if (not output) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Failed to write frames to \"%s\".", path.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    output.flush();
+    SDL_LogInfo(
+        SDL_LOG_CATEGORY_APPLICATION, "Exported %lld frames of %dx%d at %g frames per second.",
+        frameCount, width, height, framesPerSecond
+    );
+    return EXIT_SUCCESS;
+}
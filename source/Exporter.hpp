@@ -0,0 +1,24 @@
+#ifndef Exporter_hpp
+#define Exporter_hpp true
+
+#include <string>
+
+namespace Project::Exporter {
+    /**
+     * @brief Render the animation without interaction and stream the frames to a file.
+     * 
+     * @note Each frame is a pure function of its time, so frames are rendered in parallel, one frame per thread,
+     * and then written in order. Frames too large for one per thread to fit in a memory budget of 1 GiB
+     * are rendered one at a time, in bands of rows by every thread.
+     * The format is YUV4MPEG2 (4:4:4) if the path ends with ".y4m" or is "-" for the standard output,
+     * and otherwise a sequence of binary PPM images.
+     * 
+     * @param path file to write to, or "-" for the standard output
+     * @param duration length of the clip in seconds
+     * @param framesPerSecond frame rate of the clip
+     * @return exit status for `main`
+     */
+    extern int run(std::string const &path, double const duration, double const framesPerSecond);
+}
+
+#endif
@@ -0,0 +1,144 @@
+#include "FrameScheduler.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace Project::FrameScheduler {
+    #ifdef __EMSCRIPTEN__
+    // The browser calls the main loop at the display's refresh rate.
+    static double targetFrameRate{0.0};
+    #else
+    static double targetFrameRate{60.0};
+    #endif
+
+    static bool vsyncIsEnabled{false};
+
+    // Refresh rate of the display, which paces the frames with V-Sync.
+    static double refreshRate{60.0};
+
+    // Deadline of the next frame in performance counter ticks, or zero if there is none yet.
+    static Uint64 nextDeadline{0u};
+
+    static Uint64 missedDeadlineCount{0u};
+
+    // Frames and missed deadlines since the last report.
+    static Uint64 reportFrameCount{0u}, reportMissedDeadlineCount{0u};
+    static Uint64 reportStartTime{0u};
+
+    static Uint64 getPeriod(double const framesPerSecond) {
+        return static_cast<Uint64>(static_cast<double>(SDL_GetPerformanceFrequency()) / framesPerSecond);
+    }
+
+    /**
+     * @brief Log how many deadlines were missed every ten seconds, if any were.
+     */
+    static void report(Uint64 const now, double const framesPerSecond) {
+        Uint64 const frequency{SDL_GetPerformanceFrequency()};
+        if (reportStartTime == 0u) reportStartTime = now;
+        if (now - reportStartTime < 10u * frequency) return;
+
+        if (reportMissedDeadlineCount > 0u) SDL_LogInfo(
+            SDL_LOG_CATEGORY_APPLICATION, "Missed %llu of %llu frame deadlines at %g frames per second in the last %g seconds.",
+            static_cast<unsigned long long>(reportMissedDeadlineCount), static_cast<unsigned long long>(reportFrameCount),
+            framesPerSecond, static_cast<double>(now - reportStartTime) / static_cast<double>(frequency)
+        );
+
+        reportFrameCount = 0u;
+        reportMissedDeadlineCount = 0u;
+        reportStartTime = now;
+    }
+
+    /**
+     * @brief Advance the deadline by one period, or restart the deadlines from now if the deadline was missed.
+     * 
+     * @param framesPerSecond rate that the deadlines follow
+     * @param followsNow whether the next deadline is a period from now, instead of from this one,
+     * for frames that a clock other than the performance counter paces
+     */
+    static void advanceDeadline(Uint64 const now, double const framesPerSecond, bool const followsNow) {
+        Uint64 const period{getPeriod(framesPerSecond)};
+
+        ++reportFrameCount;
+        if (nextDeadline != 0u and now > nextDeadline + period / 2u) {
+            ++missedDeadlineCount;
+            ++reportMissedDeadlineCount;
+            nextDeadline = now + period;
+        } else if (nextDeadline == 0u or followsNow) {
+            nextDeadline = now + period;
+        } else {
+            nextDeadline += period;
+        }
+
+        report(now, framesPerSecond);
+    }
+}
+
+void Project::FrameScheduler::setTargetFrameRate(double const framesPerSecond) {
+    targetFrameRate = std::max(0.0, framesPerSecond);
+    nextDeadline = 0u;
+}
+
+double Project::FrameScheduler::getTargetFrameRate() { return targetFrameRate; }
+
+void Project::FrameScheduler::setVsyncEnabled(bool const isEnabled) {
+    vsyncIsEnabled = isEnabled;
+    nextDeadline = 0u;
+}
+
+bool Project::FrameScheduler::isVsyncEnabled() { return vsyncIsEnabled; }
+
+void Project::FrameScheduler::setRefreshRate(double const framesPerSecond) {
+    if (framesPerSecond > 0.0) refreshRate = framesPerSecond;
+    nextDeadline = 0u;
+}
+
+void Project::FrameScheduler::waitForNextFrame() {
+    // The present that just returned waited for the refresh; one that returns more than half a refresh late missed it.
+    if (vsyncIsEnabled) {
+        advanceDeadline(SDL_GetPerformanceCounter(), refreshRate, /* follows the display */ true);
+        return;
+    }
+
+    if (targetFrameRate <= 0.0) return;
+
+    /*
+        `SDL_Delay` sleeps for whole milliseconds and may wake late, so sleep until about a millisecond before the deadline,
+        then yield for the rest. The processor is only kept busy for that last millisecond.
+    */
+    if (nextDeadline != 0u) {
+        Uint64 const frequency{SDL_GetPerformanceFrequency()};
+        Uint64 const margin{frequency / 1000u};
+        Uint64 const now{SDL_GetPerformanceCounter()};
+        if (now + margin < nextDeadline) SDL_Delay(static_cast<Uint32>((nextDeadline - margin - now) * 1000u / frequency));
+        while (SDL_GetPerformanceCounter() < nextDeadline) std::this_thread::yield();
+    }
+
+    advanceDeadline(SDL_GetPerformanceCounter(), targetFrameRate, false);
+}
+
+bool Project::FrameScheduler::isFrameDue() {
+    Uint64 const now{SDL_GetPerformanceCounter()};
+
+    // Every animation frame is due, but one that comes more than half a refresh late missed one.
+    if (vsyncIsEnabled) {
+        advanceDeadline(now, refreshRate, /* follows the display */ true);
+        return true;
+    }
+
+    if (targetFrameRate <= 0.0) return true;
+
+    // An animation frame that comes less than half a period early is close enough.
+    if (nextDeadline != 0u and now + getPeriod(targetFrameRate) / 2u < nextDeadline) return false;
+
+    advanceDeadline(now, targetFrameRate, false);
+    return true;
+}
+
+void Project::FrameScheduler::restart() {
+    nextDeadline = 0u;
+    reportFrameCount = 0u;
+    reportMissedDeadlineCount = 0u;
+    reportStartTime = 0u;
+}
+
+Uint64 Project::FrameScheduler::getMissedDeadlineCount() { return missedDeadlineCount; }
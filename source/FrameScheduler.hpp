@@ -0,0 +1,67 @@
+#ifndef FrameScheduler_hpp
+#define FrameScheduler_hpp true
+
+#include "SdlContext.hpp"
+
+/*
+    Paces the main loop to a target frame rate.
+
+    Natively, the main loop sleeps until the deadline of the next frame.
+    In the browser, `emscripten_set_main_loop` already calls the main loop once per animation frame,
+    so the main loop never blocks; instead it skips animation frames that come before the next deadline.
+*/
+namespace Project::FrameScheduler {
+    /**
+     * @param framesPerSecond target frame rate, or zero to not limit the frame rate
+     */
+    extern void setTargetFrameRate(double const framesPerSecond);
+    extern double getTargetFrameRate();
+
+    /**
+     * @brief Let the presentation of the renderer pace the frames, instead of sleeping.
+     * 
+     * @note Set this if the renderer was created with `SDL_RENDERER_PRESENTVSYNC`.
+     */
+    extern void setVsyncEnabled(bool const isEnabled);
+    extern bool isVsyncEnabled();
+
+    /**
+     * @brief Set the refresh rate of the display, which frames are timed against with V-Sync. Sixty unless set.
+     * 
+     * @param framesPerSecond refresh rate, or zero if it is unknown, which keeps the previous one
+     */
+    extern void setRefreshRate(double const framesPerSecond);
+
+    /**
+     * @brief Sleep until the deadline of the next frame. Call it right after presenting.
+     * 
+     * @note Sleeps with `SDL_Delay` until about a millisecond before the deadline, then yields until the deadline.
+     * If the deadline has already passed by more than half a period, the frame counts as missed and the deadlines restart from now,
+     * instead of rushing frames to catch up.
+     * 
+     * @note With V-Sync, presenting already waited, so this only counts a frame as missed
+     * if the present returned more than half a refresh period after the deadline.
+     */
+    extern void waitForNextFrame();
+
+    /**
+     * @brief Check whether the next frame is due, without blocking. For loops driven by the browser.
+     * 
+     * @note With V-Sync, every frame is due, and frames that come more than half a refresh period late count as missed.
+     * 
+     * @return whether the caller should render a frame now
+     */
+    extern bool isFrameDue();
+
+    /**
+     * @brief Forget the deadlines, so that the frames after a pause neither count as missed nor rush to catch up.
+     */
+    extern void restart();
+
+    /**
+     * @return number of frames that missed their deadline since the program started
+     */
+    extern Uint64 getMissedDeadlineCount();
+}
+
+#endif
@@ -57,11 +57,11 @@ double Project::HslaColor::getCyclicHue(
 }
 
 SDL_Color Project::HslaColor::toRgbaColor() const {
-    return makeRgbaColor(this->hue, this->saturation, this->luminance, this->alpha);
+    return makeRgbaColor(static_cast<double>(getHue()), this->saturation, this->luminance, this->alpha);
 }
 
 std::string Project::HslaColor::toString() const {
     std::stringstream buffer;
-    buffer << "(H=" << hue << ", S=" << saturation << ", L=" << luminance << ", A=" << alpha << ")";
+    buffer << "(H=" << getHue() << ", S=" << saturation << ", L=" << luminance << ", A=" << alpha << ")";
     return buffer.str();
 }
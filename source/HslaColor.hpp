@@ -1,6 +1,7 @@
 #ifndef HslaColor_hpp
 #define HslaColor_hpp true
 
+#include <cstdint>
 #include <string>
 #include "SdlContext.hpp"
 #include "project_utility.hpp"
@@ -8,6 +9,34 @@
 namespace Project {
   inline constexpr SDL_Color black{0x00, 0x00, 0x00, 0xFF};
 
+  /*
+    Hue as a fraction of a turn in fixed point, where 2^32 is a whole turn.
+    Adding and subtracting phases wraps around for free by unsigned overflow.
+  */
+  using HuePhase = std::uint32_t;
+
+  // Phase of one degree of hue.
+  inline constexpr double huePhasePerDegree{4294967296.0 / 360.0};
+
+  /**
+   * @brief Convert a hue in degrees to a phase. Any hue is wrapped, as long as it is within about a billion turns of zero.
+   */
+  inline constexpr HuePhase toHuePhase(double const hue) {
+    // Round down, like `std::floor`, which is not `constexpr`, so that negative hues wrap the same way.
+    double const phase{hue * huePhasePerDegree};
+    auto const truncatedPhase{static_cast<std::int64_t>(phase)};
+    return static_cast<HuePhase>(static_cast<double>(truncatedPhase) > phase ? truncatedPhase - 1 : truncatedPhase);
+  }
+
+  /**
+   * @return hue in degrees in [0, 360)
+   */
+  inline constexpr float toDegrees(HuePhase const phase) {
+    // The last phases before a whole turn round up to 360 as floats.
+    float const hue{static_cast<float>(static_cast<double>(phase) / huePhasePerDegree)};
+    return hue < 360.0f ? hue : 0.0f;
+  }
+
   extern std::string toString(SDL_Color const &color);
 
   extern SDL_Color makeRgbaColor(
@@ -22,7 +51,8 @@ namespace Project {
 
 class Project::HslaColor {
   private:
-    float hue, saturation, luminance, alpha;
+    HuePhase huePhase;
+    float saturation, luminance, alpha;
 
   public:
     constexpr HslaColor(
@@ -31,18 +61,19 @@ class Project::HslaColor {
       float const luminanceValue=0.5f,
       float const alphaValue=1.0f
     ):
-      hue{hueValue},
+      huePhase{toHuePhase(hueValue)},
       saturation{saturationValue},
       luminance{luminanceValue},
       alpha{alphaValue}
     {}
 
-    constexpr float getHue() const { return hue; }
+    constexpr float getHue() const { return toDegrees(huePhase); }
+    constexpr HuePhase getHuePhase() const { return huePhase; }
     constexpr float getSaturation() const { return saturation; }
     constexpr float getLuminance() const { return luminance; }
     constexpr float getAlpha() const { return alpha; }
 
-    float setHue(float const hueValue) { return hue = wrapValue(hueValue, 360.0f); }
+    float setHue(float const hueValue) { return toDegrees(huePhase = toHuePhase(hueValue)); }
     float setSaturation(float const saturationValue) { return saturation = wrapValue(saturationValue, 1.0f); }
     float setLuminance(float const luminanceValue) { return luminance = wrapValue(luminanceValue, 1.0f); }
     float setAlpha(float const alphaValue) { return alpha = wrapValue(alphaValue, 1.0f); }
@@ -0,0 +1,305 @@
+#include "HueField.hpp"
+#include "KernelBackend.hpp"
+#include "project_utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+bool Project::HueField::setInputs(
+    PointList const &pointListValue,
+    float const hueScaleValue,
+    float const reuseDistance,
+    int const strideValue,
+    float const toleranceValue
+) {
+    auto const isCloseEnough = [this, &pointListValue, reuseDistance]() -> bool {
+        if (pointListValue.size() != pointList.size() or pointListValue.weightList != pointList.weightList) return false;
+        for (std::size_t index{0u}; index < pointList.size(); ++index) {
+            float const dx{pointListValue.xList[index] - pointList.xList[index]};
+            float const dy{pointListValue.yList[index] - pointList.yList[index]};
+            if (dx * dx + dy * dy > reuseDistance * reuseDistance) return false;
+        }
+        return true;
+    };
+
+    // A field computed at least as finely and as accurately as asked for can be reused.
+    if (
+        hasInputs and hueScaleValue == hueScale and
+        stride <= strideValue and tolerance <= toleranceValue and isCloseEnough()
+    ) return false;
+
+    pointList = pointListValue;
+    hueScale = hueScaleValue;
+    stride = std::max(1, strideValue);
+    hasInputs = true;
+
+    // In the coarse grid of samples, distances are `stride` times shorter.
+    samplePointList = pointList;
+    for (float &x : samplePointList.xList) x /= static_cast<float>(stride);
+    for (float &y : samplePointList.yList) y /= static_cast<float>(stride);
+
+    // Choose the kernel for the whole frame: specialized if the sinks come first and there are few enough of each.
+    std::size_t const sinkCountValue{static_cast<std::size_t>(
+        std::find_if(pointList.weightList.begin(), pointList.weightList.end(), [](float const weight) { return weight != +1.0f; }) -
+        pointList.weightList.begin()
+    )};
+    std::size_t const sourceCountValue{pointList.size() - sinkCountValue};
+    isSpecialized =
+        sinkCountValue <= maxSpecializedPointCount and sourceCountValue <= maxSpecializedPointCount and
+        std::all_of(pointList.weightList.begin() + static_cast<std::ptrdiff_t>(sinkCountValue), pointList.weightList.end(), [](float const weight) {
+            return weight == -1.0f;
+        });
+    sinkCount = sinkCountValue;
+    sourceCount = sourceCountValue;
+
+    // With more points than a cell for every `cellsPerPoint`, nearly every cell is refined, which costs more than every pixel.
+    std::size_t const cellCount{
+        static_cast<std::size_t>((width + cellSize - 1) / cellSize) * static_cast<std::size_t>((height + cellSize - 1) / cellSize)
+    };
+
+    // A field that is not interpolated is exact, whatever the tolerance was.
+    isInterpolated =
+        toleranceValue > 0.0f and stride == 1 and
+        pointList.size() >= minInterpolatedPointCount and pointList.size() * cellsPerPoint <= cellCount;
+    tolerance = isInterpolated ? toleranceValue : 0.0f;
+
+    return true;
+}
+
+void Project::HueField::computeRow(
+    Phase *const row,
+    int const rowWidth,
+    float const startX,
+    float const y,
+    PointList const &rowPointList,
+    float const rowHueScale,
+    std::vector<float> &distanceSumList
+) const {
+    KernelBackend::Table const &kernels{backend != nullptr ? *backend : KernelBackend::getSelected()};
+    if (isSpecialized) {
+        kernels.specializedRowTable[sinkCount][sourceCount](row, rowWidth, startX, y, rowPointList, rowHueScale);
+        return;
+    }
+
+    distanceSumList.resize(static_cast<std::size_t>(rowWidth));
+    kernels.computeRow(row, rowWidth, startX, y, rowPointList, rowHueScale, distanceSumList.data());
+}
+
+void Project::HueField::computeRows(int const beginRow, int const endRow, int const beginColumn, int const endColumn, Scratch &scratch) {
+    int const tileWidth{endColumn - beginColumn};
+
+    if (isInterpolated) {
+        computeRowsInterpolated(beginRow, endRow, beginColumn, tileWidth, scratch);
+        return;
+    }
+
+    if (stride == 1) {
+        for (int y{beginRow}; y < endRow; ++y) computeRow(
+            getRow(y) + beginColumn, tileWidth, static_cast<float>(beginColumn), static_cast<float>(y), pointList, hueScale, scratch.distanceSumList
+        );
+        return;
+    }
+
+    // Compute one sample for every block of `stride` by `stride` pixels, at its top left pixel, and fill the block with it.
+    int const sampleWidth{(tileWidth + stride - 1) / stride};
+    std::vector<Phase> &sampleRow{scratch.sampleRow};
+    sampleRow.resize(static_cast<std::size_t>(sampleWidth));
+    for (int y{beginRow}; y < endRow; ++y) {
+        Phase *const row{getRow(y) + beginColumn};
+
+        // The first row of a range that starts inside a block computes the block's samples itself, so ranges stay independent.
+        if (y % stride != 0 and y != beginRow) {
+            std::copy(getRow(y - 1) + beginColumn, getRow(y - 1) + endColumn, row);
+            continue;
+        }
+
+        computeRow(
+            sampleRow.data(), sampleWidth, static_cast<float>(beginColumn / stride), static_cast<float>(y / stride),
+            samplePointList, hueScale * static_cast<float>(stride), scratch.distanceSumList
+        );
+        for (int sampleX{0}; sampleX < sampleWidth; ++sampleX) {
+            std::fill(row + sampleX * stride, row + std::min(tileWidth, (sampleX + 1) * stride), sampleRow[static_cast<std::size_t>(sampleX)]);
+        }
+    }
+}
+
+void Project::HueField::computeRowsInterpolated(
+    int const beginRow, int const endRow, int const beginColumn, int const tileWidth, Scratch &scratch
+) {
+    KernelBackend::Table const &kernels{backend != nullptr ? *backend : KernelBackend::getSelected()};
+
+    // Cells that cross the right edge are filled whole, past the edge, so every cell has the same layout.
+    int const columnCount{(tileWidth + cellSize - 1) / cellSize};
+    int const subcellColumnCount{2 * columnCount};
+    int const rowLength{columnCount * cellSize};
+    std::vector<float> &sumList{scratch.sumList};
+    sumList.resize(static_cast<std::size_t>(rowLength) * static_cast<std::size_t>(cellSize));
+
+    // Samples are taken relative to the tile, which starts this far into the rows.
+    float const originX{static_cast<float>(beginColumn)};
+
+    // Largest interpolation error in sums of distances that a block may have at its samples.
+    float const errorLimit{0.5f * tolerance / std::abs(hueScale)};
+
+    /*
+        Exact samples every half subcell, on the five rows that are that far apart in a row of cells. Every other row and column
+        (the corners, middles of edges, and centers of cells) is sampled for every cell, and the rest only around cells that are split.
+    */
+    static constexpr int sampleSpacing{subcellSize / 2};
+    std::size_t const gridLength{static_cast<std::size_t>(2 * subcellColumnCount + 1)};
+    std::array<std::vector<float>, 5u> &gridList{scratch.gridList};
+    for (auto &grid : gridList) grid.resize(gridLength);
+    std::vector<float> &scratchList{scratch.sampleList};
+    scratchList.resize(gridLength);
+
+    // Whether each cell, and each subcell by row of subcells, is near a point, is split, or is computed at every pixel.
+    std::vector<bool> &cellIsNearList{scratch.cellIsNearList}, &cellIsSplitList{scratch.cellIsSplitList};
+    cellIsNearList.resize(static_cast<std::size_t>(columnCount));
+    cellIsSplitList.resize(static_cast<std::size_t>(columnCount));
+    std::array<std::vector<bool>, 2u> &subcellIsNearList{scratch.subcellIsNearList}, &subcellIsExactList{scratch.subcellIsExactList};
+    for (auto &list : subcellIsNearList) list.resize(static_cast<std::size_t>(subcellColumnCount));
+    for (auto &list : subcellIsExactList) list.resize(static_cast<std::size_t>(subcellColumnCount));
+
+    // A distance bends sharply near its point, which the samples of a block may straddle, so blocks within their size of a point are split.
+    auto const markNearBlocks = [this, originX](std::vector<bool> &isNearList, int const size, int const blockTop) -> void {
+        float const blockSize{static_cast<float>(size)};
+        float const centerY{static_cast<float>(blockTop) + 0.5f * blockSize};
+        std::fill(isNearList.begin(), isNearList.end(), false);
+        for (std::size_t index{0u}; index < pointList.size(); ++index) {
+            if (std::abs(pointList.yList[index] - centerY) > blockSize) continue;
+            float const x{(pointList.xList[index] - originX) / blockSize};
+            int const first{std::max(0, static_cast<int>(std::ceil(x - 1.5f)))};
+            int const last{std::min(static_cast<int>(isNearList.size()) - 1, static_cast<int>(std::floor(x + 0.5f)))};
+            for (int column{first}; column <= last; ++column) isNearList[static_cast<std::size_t>(column)] = true;
+        }
+    };
+
+    // Call `function(first, count)` for every run of neighbors that are marked in a list.
+    auto const forEachRun = [](std::vector<bool> const &isMarkedList, auto const &function) -> void {
+        for (std::size_t first{0u}; first < isMarkedList.size(); ++first) {
+            if (not isMarkedList[first]) continue;
+            std::size_t last{first};
+            while (last + 1u < isMarkedList.size() and isMarkedList[last + 1u]) ++last;
+            function(static_cast<int>(first), static_cast<int>(last - first + 1u));
+            first = last;
+        }
+    };
+
+    auto const getBlockGrid = [&gridList](std::size_t const gridRow, std::size_t const gridIndex, std::size_t const step) -> SampleGrid {
+        SampleGrid grid;
+        for (std::size_t row{0u}; row < 3u; ++row) for (std::size_t index{0u}; index < 3u; ++index) {
+            grid[row][index] = gridList[gridRow + row * step][gridIndex + index * step];
+        }
+        return grid;
+    };
+
+    auto const sampleCoarseRow = [&](std::vector<float> &grid, int const y) -> void {
+        kernels.sampleDistanceSums(scratchList.data(), subcellColumnCount + 1, originX, static_cast<float>(subcellSize), static_cast<float>(y), pointList);
+        for (int index{0}; index <= subcellColumnCount; ++index) grid[static_cast<std::size_t>(2 * index)] = scratchList[static_cast<std::size_t>(index)];
+    };
+
+    int const firstTop{beginRow - beginRow % cellSize};
+    sampleCoarseRow(gridList[4], firstTop);
+    for (int top{firstTop}; top < endRow; top += cellSize) {
+        std::swap(gridList[0], gridList[4]);
+        sampleCoarseRow(gridList[2], top + subcellSize);
+        sampleCoarseRow(gridList[4], top + cellSize);
+
+        markNearBlocks(cellIsNearList, cellSize, top);
+        markNearBlocks(subcellIsNearList[0], subcellSize, top);
+        markNearBlocks(subcellIsNearList[1], subcellSize, top + subcellSize);
+        std::fill(cellIsSplitList.begin(), cellIsSplitList.end(), false);
+        for (auto &list : subcellIsExactList) std::fill(list.begin(), list.end(), false);
+
+        // Interpolate the cells that are smooth enough, and split the rest, unless their subcells cannot be smooth enough either.
+        for (int column{0}; column < columnCount; ++column) {
+            std::size_t const index{static_cast<std::size_t>(column)};
+            SampleGrid const grid{getBlockGrid(0u, 4u * index, 2u)};
+            float const error{getInterpolationError(grid)};
+            if (not cellIsNearList[index] and error <= errorLimit) {
+                interpolateBlock(sumList.data() + column * cellSize, rowLength, cellSize, grid);
+                continue;
+            }
+
+            // Halving a block quarters the error of a smooth field, so a subcell of a cell that is this far off would be too.
+            bool const subcellsAreNear{
+                subcellIsNearList[0][2u * index] and subcellIsNearList[0][2u * index + 1u] and
+                subcellIsNearList[1][2u * index] and subcellIsNearList[1][2u * index + 1u]
+            };
+            if (subcellsAreNear or error > 8.0f * errorLimit) {
+                for (auto &list : subcellIsExactList) list[2u * index] = list[2u * index + 1u] = true;
+            } else cellIsSplitList[index] = true;
+        }
+
+        // Sample the split cells every half subcell.
+        forEachRun(cellIsSplitList, [&](int const first, int const count) -> void {
+            for (std::size_t row{0u}; row < gridList.size(); ++row) {
+                int const y{top + static_cast<int>(row) * sampleSpacing};
+                std::size_t const firstIndex{4u * static_cast<std::size_t>(first)};
+                if (row % 2u == 1u) {
+                    kernels.sampleDistanceSums(
+                        gridList[row].data() + firstIndex, 4 * count + 1, originX + static_cast<float>(first * cellSize), static_cast<float>(sampleSpacing),
+                        static_cast<float>(y), pointList
+                    );
+                } else {
+                    kernels.sampleDistanceSums(
+                        scratchList.data(), 2 * count, originX + static_cast<float>(first * cellSize + sampleSpacing), static_cast<float>(subcellSize),
+                        static_cast<float>(y), pointList
+                    );
+                    for (int index{0}; index < 2 * count; ++index) {
+                        gridList[row][firstIndex + 2u * static_cast<std::size_t>(index) + 1u] = scratchList[static_cast<std::size_t>(index)];
+                    }
+                }
+            }
+        });
+
+        // Interpolate the subcells of split cells that are smooth enough, and mark the rest.
+        for (int column{0}; column < columnCount; ++column) {
+            if (not cellIsSplitList[static_cast<std::size_t>(column)]) continue;
+            for (std::size_t subcellY{0u}; subcellY < 2u; ++subcellY) for (std::size_t subcellX{0u}; subcellX < 2u; ++subcellX) {
+                std::size_t const subcellIndex{2u * static_cast<std::size_t>(column) + subcellX};
+                SampleGrid const grid{getBlockGrid(2u * subcellY, 2u * subcellIndex, 1u)};
+                if (not subcellIsNearList[subcellY][subcellIndex] and getInterpolationError(grid) <= errorLimit) interpolateBlock(
+                    sumList.data() + static_cast<std::ptrdiff_t>(subcellY) * subcellSize * rowLength + static_cast<std::ptrdiff_t>(subcellIndex) * subcellSize,
+                    rowLength, subcellSize, grid
+                );
+                else subcellIsExactList[subcellY][subcellIndex] = true;
+            }
+        }
+
+        // Compute the rest at every pixel, in runs of neighbors, so that the loop over a run is vectorized.
+        for (int subcellY{0}; subcellY < 2; ++subcellY) forEachRun(subcellIsExactList[static_cast<std::size_t>(subcellY)], [&](int const first, int const count) -> void {
+            for (int row{subcellY * subcellSize}; row < (subcellY + 1) * subcellSize; ++row) kernels.sampleDistanceSums(
+                sumList.data() + static_cast<std::ptrdiff_t>(row) * rowLength + first * subcellSize, count * subcellSize,
+                originX + static_cast<float>(first * subcellSize), 1.0f, static_cast<float>(top + row), pointList
+            );
+        });
+
+        // Wrap once per pixel, like the other kernels.
+        for (int y{std::max(top, beginRow)}; y < std::min(top + cellSize, endRow); ++y) kernels.convertSumRow(
+            getRow(y) + beginColumn, sumList.data() + static_cast<std::ptrdiff_t>(y - top) * rowLength, tileWidth, hueScale
+        );
+    }
+}
+
+float Project::HueField::getInterpolationError(SampleGrid const &grid) {
+    return std::max({
+        std::abs(grid[1][1] - 0.25f * (grid[0][0] + grid[0][2] + grid[2][0] + grid[2][2])),
+        std::abs(grid[0][1] - 0.5f * (grid[0][0] + grid[0][2])),
+        std::abs(grid[2][1] - 0.5f * (grid[2][0] + grid[2][2])),
+        std::abs(grid[1][0] - 0.5f * (grid[0][0] + grid[2][0])),
+        std::abs(grid[1][2] - 0.5f * (grid[0][2] + grid[2][2]))
+    });
+}
+
+void Project::HueField::interpolateBlock(float *const sumList, int const rowLength, int const size, SampleGrid const &grid) {
+    for (int row{0}; row < size; ++row) {
+        float const percentage{static_cast<float>(row) / static_cast<float>(size)};
+        float const left{linearInterpolation(percentage, grid[0][0], grid[2][0])};
+        float const right{linearInterpolation(percentage, grid[0][2], grid[2][2])};
+        float const step{(right - left) / static_cast<float>(size)};
+        float *const sumRow{sumList + static_cast<std::ptrdiff_t>(row) * rowLength};
+        for (int column{0}; column < size; ++column) sumRow[column] = left + step * static_cast<float>(column);
+    }
+}
@@ -0,0 +1,221 @@
+#ifndef HueField_hpp
+#define HueField_hpp true
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "SdlContext.hpp"
+#include "HslaColor.hpp"
+
+namespace Project {
+  namespace KernelBackend { struct Table; }
+
+  class HueField;
+}
+
+/**
+ * @brief Spatial part of the hue of every pixel of the canvas, stored as one contiguous array of 16-bit phases.
+ * 
+ * @note The hue of a pixel is the base hue plus, for every point, the distance to the point
+ * times the weight of the point times the hue scale. Sinks have a weight of `+1` and sources a weight of `-1`.
+ * Because every contribution is linear in distance, the distances are summed first
+ * and the sum is converted to a phase, which wraps it, only once per pixel.
+ * 
+ * @note The field holds the hue without the base hue, which is a uniform rotation that is added when the hues are looked up.
+ * So the field depends only on the points and the hue scale, and frames in which those barely move can reuse it.
+ */
+class Project::HueField {
+  public:
+    /*
+      Hue of a pixel of the field: the top 16 bits of a hue phase, about 0.0055 degrees apart, which is a sixteenth of a step
+      of the hue table. Half as wide as a hue phase, so that the field streams half as many bytes through memory on large canvases.
+    */
+    using Phase = std::uint16_t;
+    static constexpr double phasePerDegree{65536.0 / 360.0};
+
+    static constexpr Phase toPhase(HuePhase const hue) { return static_cast<Phase>(hue >> 16u); }
+
+    // Largest number of sinks, and of sources, that has a specialized kernel.
+    static constexpr std::size_t maxSpecializedPointCount{4u};
+
+    /*
+      Side in pixels of the cells of the coarse grid of an interpolated field. Ranges of rows that start at a multiple of it
+      compute each cell once.
+    */
+    static constexpr int cellSize{8};
+
+    // Side in pixels of the quarters that a cell is split into when it is refined. Quarters that need refining are computed at every pixel.
+    static constexpr int subcellSize{cellSize / 2};
+
+    // Fewest points for which a field with a tolerance is interpolated; with fewer, every pixel is as fast to compute.
+    static constexpr std::size_t minInterpolatedPointCount{16u};
+
+    // Fewest cells of the coarse grid for every point of a field with a tolerance that is interpolated.
+    static constexpr std::size_t cellsPerPoint{8u};
+
+    /**
+     * @brief Points that contribute to the field, as a structure of arrays.
+     * 
+     * @note A list of sinks followed by sources, at most `maxSpecializedPointCount` of each,
+     * is computed by a kernel specialized by the number of sinks and sources.
+     */
+    struct PointList {
+      std::vector<float> xList, yList, weightList;
+
+      void clear() { xList.clear(); yList.clear(); weightList.clear(); }
+      void add(SDL_FPoint const &point, float const weight) {
+        xList.push_back(point.x); yList.push_back(point.y); weightList.push_back(weight);
+      }
+      std::size_t size() const { return weightList.size(); }
+    };
+
+    /**
+     * @brief Rows that `computeRows` works in. Kept between calls by each thread that computes tiles,
+     * so that once they have grown to the size of a tile, computing a tile allocates nothing.
+     */
+    struct Scratch {
+      std::vector<float> distanceSumList, sumList, sampleList;
+      std::vector<Phase> sampleRow;
+      std::array<std::vector<float>, 5u> gridList;
+      std::vector<bool> cellIsNearList, cellIsSplitList;
+      std::array<std::vector<bool>, 2u> subcellIsNearList, subcellIsExactList;
+    };
+
+    HueField(int const widthValue, int const heightValue):
+      width{widthValue}, height{heightValue}, phaseList(static_cast<std::size_t>(widthValue) * static_cast<std::size_t>(heightValue))
+    {}
+
+    /**
+     * @brief Change the size of the field. The hues are left unspecified until the field is recomputed.
+     */
+    void resize(int const widthValue, int const heightValue) {
+      width = widthValue;
+      height = heightValue;
+      phaseList.resize(static_cast<std::size_t>(widthValue) * static_cast<std::size_t>(heightValue));
+      hasInputs = false;
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    /**
+     * @brief Compute the rows with the kernels of a backend from now on.
+     * 
+     * @param value backend, or null for `KernelBackend::getSelected()`
+     */
+    void setBackend(KernelBackend::Table const *const value) { backend = value; }
+
+    Phase const *getRow(int const y) const { return phaseList.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width); }
+    Phase *getRow(int const y) { return phaseList.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width); }
+
+    /**
+     * @brief Set the inputs of the field, unless the field that was computed from the current inputs is close enough.
+     * 
+     * @note The field is close enough when the points are the same in number and weight,
+     * none of them moved farther than `reuseDistance`, the hue scale is the same,
+     * and the field was computed with a stride and a tolerance no greater than `stride` and `tolerance`.
+     * 
+     * @note With a tolerance, a stride of 1, and at least `minInterpolatedPointCount` points but no more than one for every
+     * `cellsPerPoint` cells, the field is computed exactly
+     * at the corners of a coarse grid of cells and interpolated inside them. A cell near a point, or whose interpolation
+     * is off by more than half the tolerance at the middles of its edges or at its center, is split into four subcells,
+     * which are refined the same way once more and then computed at every pixel.
+     * Then the cost of the field grows with the number of cells near the points instead of with the number of pixels.
+     * 
+     * @note Not thread-safe.
+     * 
+     * @param pointList points that contribute to every pixel; copied
+     * @param hueScale hue in degrees per unit of weighted distance
+     * @param reuseDistance farthest distance in pixels that a point may move without the field being recomputed
+     * @param stride side in pixels of the blocks that share one computed hue; 1 computes every pixel
+     * @param tolerance largest error in degrees of hue that interpolation may make, or zero to compute every pixel
+     * @return whether the inputs changed, so that every row must be recomputed with `computeRows`
+     */
+    bool setInputs(
+      PointList const &pointList,
+      float const hueScale,
+      float const reuseDistance,
+      int const stride=1,
+      float const tolerance=0.0f
+    );
+
+    /**
+     * @brief Compute the phases of the columns [`beginColumn`, `endColumn`) of the rows [`beginRow`, `endRow`) from the inputs.
+     * 
+     * @note With a stride above 1, the hue of every block of pixels is computed at its top left pixel,
+     * so ranges of rows that start at a multiple of the stride compute each block once. Ranges of columns
+     * should start at a multiple of `cellSize` and of the stride, so that they share no blocks nor cells.
+     * 
+     * @note Thread-safe for tiles that do not overlap, with a scratch for each thread.
+     */
+    void computeRows(int const beginRow, int const endRow, int const beginColumn, int const endColumn, Scratch &scratch);
+    void computeRows(int const beginRow, int const endRow) {
+      Scratch scratch;
+      computeRows(beginRow, endRow, 0, width, scratch);
+    }
+
+  private:
+    int width, height;
+    std::vector<Phase> phaseList;
+
+    // Backend whose kernels compute the rows, or null for the selected one.
+    KernelBackend::Table const *backend{nullptr};
+
+    // Inputs that the hues were computed from, if they were set since the last resize.
+    PointList pointList;
+    float hueScale{0.0f};
+    int stride{1};
+    float tolerance{0.0f};
+    bool hasInputs{false};
+
+    // Points in units of blocks of `stride` pixels.
+    PointList samplePointList;
+
+    // Whether the rows are computed by the kernel specialized for this many sinks and sources.
+    bool isSpecialized{false};
+    std::size_t sinkCount{0u}, sourceCount{0u};
+
+    // Whether the rows are interpolated inside the cells of a coarse grid.
+    bool isInterpolated{false};
+
+    /**
+     * @brief Compute a row of `rowWidth` hue phases from `(startX, y)`, in the units that the points are in.
+     * 
+     * @param distanceSumList scratch row of the generic kernel
+     */
+    void computeRow(
+      Phase *const row,
+      int const rowWidth,
+      float const startX,
+      float const y,
+      PointList const &rowPointList,
+      float const rowHueScale,
+      std::vector<float> &distanceSumList
+    ) const;
+
+    /**
+     * @brief Compute `tileWidth` columns of the rows [`beginRow`, `endRow`) by interpolating inside the cells of the coarse grid.
+     */
+    void computeRowsInterpolated(int const beginRow, int const endRow, int const beginColumn, int const tileWidth, Scratch &scratch);
+
+    // Exact sums of weighted distances at the corners, the middles of the edges, and the center of a block, by row.
+    using SampleGrid = std::array<std::array<float, 3u>, 3u>;
+
+    /**
+     * @return largest difference between the exact sums at the middles of the edges and the center of a block and their interpolation
+     * 
+     * @note The error of interpolating is largest near these samples, but not at them, so blocks are only interpolated
+     * when this is within half the tolerance.
+     */
+    static float getInterpolationError(SampleGrid const &grid);
+
+    /**
+     * @brief Fill the sums of weighted distances of a square block by interpolating between its corners.
+     * 
+     * @param sumList sum of the top left pixel of the block, in rows that are `rowLength` floats apart
+     * @param size side of the block in pixels
+     */
+    static void interpolateBlock(float *const sumList, int const rowLength, int const size, SampleGrid const &grid);
+};
+
+#endif
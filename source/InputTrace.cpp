@@ -0,0 +1,239 @@
+#include "InputTrace.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace Project::InputTrace {
+    static constexpr char magic[]{"CDTRACE"};
+    static constexpr std::size_t magicLength{sizeof(magic) - 1u};
+    static constexpr unsigned char version{1u};
+
+    // First byte of every record after the header.
+    enum struct Tag : unsigned char {
+        frame,
+        mouseButtonDown, mouseButtonUp, mouseMotion,
+        fingerDown, fingerMotion, fingerUp,
+        multiGesture,
+        window,
+    };
+
+    static std::ofstream file;
+
+    // Time of the last recorded iteration; iterations store the time since the one before, which is short.
+    static Uint64 previousTime{0u};
+
+    static void writeByte(unsigned char const byte) { file.put(static_cast<char>(byte)); }
+
+    static void writeTag(Tag const tag) { writeByte(static_cast<unsigned char>(tag)); }
+
+    static void writeUnsigned(Uint64 value) {
+        for (; value >= 0x80u; value >>= 7u) writeByte(static_cast<unsigned char>(value | 0x80u));
+        writeByte(static_cast<unsigned char>(value));
+    }
+
+    // Zigzag-encode, so that numbers near zero of either sign are short.
+    static void writeSigned(Sint64 const value) {
+        writeUnsigned((static_cast<Uint64>(value) << 1u) ^ (value < 0 ? ~Uint64{0u} : Uint64{0u}));
+    }
+
+    static void writeFloat(float const value) {
+        Uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (unsigned shift{0u}; shift < 32u; shift += 8u) writeByte(static_cast<unsigned char>(bits >> shift));
+    }
+
+    /**
+     * @brief Reads the numbers of a trace in the order that they were written, and remembers whether it ran past the end.
+     */
+    struct Reader {
+        std::string const &byteList;
+        std::size_t index{0u};
+        bool isPastEnd{false};
+
+        unsigned char readByte() {
+            if (index >= byteList.size()) {
+                isPastEnd = true;
+                return 0u;
+            }
+            return static_cast<unsigned char>(byteList[index++]);
+        }
+
+        Uint64 readUnsigned() {
+            Uint64 value{0u};
+            for (unsigned shift{0u}; shift < 64u; shift += 7u) {
+                unsigned char const byte{readByte()};
+                value |= static_cast<Uint64>(byte & 0x7Fu) << shift;
+                if ((byte & 0x80u) == 0u) break;
+            }
+            return value;
+        }
+
+        Sint64 readSigned() {
+            Uint64 const value{readUnsigned()};
+            return static_cast<Sint64>((value >> 1u) ^ ((value & 1u) != 0u ? ~Uint64{0u} : Uint64{0u}));
+        }
+
+        float readFloat() {
+            Uint32 bits{0u};
+            for (unsigned shift{0u}; shift < 32u; shift += 8u) bits |= static_cast<Uint32>(readByte()) << shift;
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    };
+}
+
+bool Project::InputTrace::startRecording(std::string const &path, int const windowWidth, int const windowHeight) {
+    stopRecording();
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (not file.is_open()) return false;
+
+    file.write(magic, magicLength);
+    writeByte(version);
+    writeUnsigned(static_cast<Uint64>(windowWidth));
+    writeUnsigned(static_cast<Uint64>(windowHeight));
+    previousTime = 0u;
+    return true;
+}
+
+void Project::InputTrace::stopRecording() {
+    if (file.is_open()) file.close();
+}
+
+void Project::InputTrace::recordFrame(Uint64 const time) {
+    if (not file.is_open()) return;
+
+    writeTag(Tag::frame);
+    writeUnsigned(time - previousTime);
+    previousTime = time;
+}
+
+void Project::InputTrace::recordEvent(SDL_Event const &event) {
+    if (not file.is_open()) return;
+
+    switch (event.type) {
+        case SDL_MOUSEBUTTONDOWN: case SDL_MOUSEBUTTONUP:
+            writeTag(event.type == SDL_MOUSEBUTTONDOWN ? Tag::mouseButtonDown : Tag::mouseButtonUp);
+            writeUnsigned(event.button.button);
+            writeSigned(event.button.x);
+            writeSigned(event.button.y);
+            break;
+        case SDL_MOUSEMOTION:
+            writeTag(Tag::mouseMotion);
+            writeSigned(event.motion.x);
+            writeSigned(event.motion.y);
+            break;
+        case SDL_FINGERDOWN: case SDL_FINGERMOTION: case SDL_FINGERUP:
+            writeTag(event.type == SDL_FINGERDOWN ? Tag::fingerDown : event.type == SDL_FINGERMOTION ? Tag::fingerMotion : Tag::fingerUp);
+            writeSigned(event.tfinger.fingerId);
+            writeFloat(event.tfinger.x);
+            writeFloat(event.tfinger.y);
+            break;
+        case SDL_MULTIGESTURE:
+            writeTag(Tag::multiGesture);
+            writeFloat(event.mgesture.dDist);
+            writeUnsigned(event.mgesture.numFingers);
+            break;
+        case SDL_WINDOWEVENT:
+            writeTag(Tag::window);
+            writeUnsigned(event.window.event);
+            writeSigned(event.window.data1);
+            writeSigned(event.window.data2);
+            break;
+        default:
+            /* does not change the picture; do not record */;
+            break;
+    }
+}
+
+std::optional<Project::InputTrace::Trace> Project::InputTrace::load(std::string const &path) {
+    std::ifstream input(path, std::ios::binary);
+    if (not input.is_open()) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Failed to open the input trace \"%s\".", path.c_str());
+        return std::nullopt;
+    }
+    std::string const byteList{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+
+    if (byteList.size() <= magicLength or byteList.compare(0u, magicLength, magic) != 0 or byteList[magicLength] != version) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "\"%s\" is not an input trace of version %d.", path.c_str(), version);
+        return std::nullopt;
+    }
+
+    Reader reader{byteList, magicLength + 1u};
+
+    SDL_Event sizeEvent{};
+    sizeEvent.type = SDL_WINDOWEVENT;
+    sizeEvent.window.event = SDL_WINDOWEVENT_SIZE_CHANGED;
+    sizeEvent.window.data1 = static_cast<Sint32>(reader.readUnsigned());
+    sizeEvent.window.data2 = static_cast<Sint32>(reader.readUnsigned());
+
+    Trace trace;
+    Uint64 time{0u};
+    while (reader.index < byteList.size()) {
+        std::size_t const recordIndex{reader.index};
+        auto const tag{static_cast<Tag>(reader.readByte())};
+
+        SDL_Event event{};
+        switch (tag) {
+            case Tag::frame:
+                time += reader.readUnsigned();
+                break;
+            case Tag::mouseButtonDown: case Tag::mouseButtonUp:
+                event.type = tag == Tag::mouseButtonDown ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+                event.button.button = static_cast<Uint8>(reader.readUnsigned());
+                event.button.x = static_cast<Sint32>(reader.readSigned());
+                event.button.y = static_cast<Sint32>(reader.readSigned());
+                break;
+            case Tag::mouseMotion:
+                event.type = SDL_MOUSEMOTION;
+                event.motion.x = static_cast<Sint32>(reader.readSigned());
+                event.motion.y = static_cast<Sint32>(reader.readSigned());
+                break;
+            case Tag::fingerDown: case Tag::fingerMotion: case Tag::fingerUp:
+                event.type = tag == Tag::fingerDown ? SDL_FINGERDOWN : tag == Tag::fingerMotion ? SDL_FINGERMOTION : SDL_FINGERUP;
+                event.tfinger.fingerId = static_cast<SDL_FingerID>(reader.readSigned());
+                event.tfinger.x = reader.readFloat();
+                event.tfinger.y = reader.readFloat();
+                break;
+            case Tag::multiGesture:
+                event.type = SDL_MULTIGESTURE;
+                event.mgesture.dDist = reader.readFloat();
+                event.mgesture.numFingers = static_cast<Uint16>(reader.readUnsigned());
+                break;
+            case Tag::window:
+                event.type = SDL_WINDOWEVENT;
+                event.window.event = static_cast<Uint8>(reader.readUnsigned());
+                event.window.data1 = static_cast<Sint32>(reader.readSigned());
+                event.window.data2 = static_cast<Sint32>(reader.readSigned());
+                break;
+            default:
+                SDL_LogCritical(
+                    SDL_LOG_CATEGORY_APPLICATION, "The input trace \"%s\" has an unknown record at byte %zu.", path.c_str(), recordIndex
+                );
+                return std::nullopt;
+        }
+
+        // A recording that was cut off, by a crash for example, is replayed up to its last whole record.
+        if (reader.isPastEnd) {
+            SdlContext::warn("The input trace \"", path, "\" ends in the middle of a record, at byte ", recordIndex, ".");
+            break;
+        }
+
+        if (tag == Tag::frame) {
+            trace.frameList.push_back({time, {}});
+            if (trace.frameList.size() == 1u) trace.frameList.back().eventList.push_back(sizeEvent);
+            continue;
+        }
+
+        if (trace.frameList.empty()) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "The input trace \"%s\" has an event before its first iteration.", path.c_str());
+            return std::nullopt;
+        }
+        event.common.timestamp = static_cast<Uint32>(time);
+        trace.frameList.back().eventList.push_back(event);
+    }
+
+    return trace;
+}
@@ -0,0 +1,71 @@
+#ifndef InputTrace_hpp
+#define InputTrace_hpp true
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "SdlContext.hpp"
+
+/*
+    Recording of the input events that the main loop consumes, iteration by iteration, so that sessions can be replayed as benchmarks.
+
+    A trace file holds the bytes `CDTRACE`, a version byte, and the window size, then, for every iteration of the main loop,
+    its time followed by the events that it handled. Numbers are LEB128 integers (zigzag-encoded if signed) and little-endian floats.
+    Only the events that change the picture are kept, with only the fields that the main loop reads:
+    mouse buttons and motion, fingers, pinches, and changes of the window's size and visibility.
+*/
+namespace Project::InputTrace {
+    struct Frame {
+        // Time of the iteration in milliseconds, on the clock of `SDL_GetTicks64`.
+        Uint64 time;
+
+        std::vector<SDL_Event> eventList;
+    };
+
+    struct Trace {
+        std::vector<Frame> frameList;
+
+        // Duration of the recording in milliseconds, from the first iteration to the last.
+        Uint64 getDuration() const { return frameList.empty() ? 0u : frameList.back().time - frameList.front().time; }
+    };
+
+    /**
+     * @brief Write every iteration of the main loop to a trace file from now on, until `stopRecording`.
+     * 
+     * @param windowWidth width of the window, which mouse positions are relative to
+     * @param windowHeight height of the window
+     * @return whether the file could be created
+     */
+    extern bool startRecording(std::string const &path, int const windowWidth, int const windowHeight);
+
+    /**
+     * @brief Write what is buffered and close the trace file. Does nothing if nothing is being recorded.
+     */
+    extern void stopRecording();
+
+    /**
+     * @brief Record the start of an iteration of the main loop; the events recorded after it belong to it.
+     * 
+     * @note Does nothing if nothing is being recorded. Not thread-safe.
+     */
+    extern void recordFrame(Uint64 const time);
+
+    /**
+     * @brief Record an event that the main loop handled. Events that do not change the picture are skipped.
+     * 
+     * @note Does nothing if nothing is being recorded. Not thread-safe.
+     */
+    extern void recordEvent(SDL_Event const &event);
+
+    /**
+     * @brief Read a whole trace file.
+     * 
+     * @note The window size at the start of the recording comes first among the events of the first iteration, as a size change,
+     * so that replaying it maps mouse positions to the canvas the same way.
+     * 
+     * @return the trace, or nothing if the file cannot be read or is not a trace, which is logged
+     */
+    extern std::optional<Trace> load(std::string const &path);
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include "KernelBackend.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace Project::KernelBackend {
+    /**
+     * @return backends that this processor supports, oldest instruction set first
+     */
+    static std::vector<Table const *> findSupportedList() {
+        std::vector<Table const *> supportedList{&baselineTable};
+
+        #ifdef PROJECT_KERNEL_DISPATCH
+        // These also check that the operating system saves the wider registers.
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.1")) supportedList.push_back(&sse4_1Table);
+        if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma")) supportedList.push_back(&avx2Table);
+        if (
+            __builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512vl") and
+            __builtin_cpu_supports("avx512bw") and __builtin_cpu_supports("avx512dq")
+        ) supportedList.push_back(&avx512Table);
+        #endif
+
+        return supportedList;
+    }
+
+    static Table const &choose() {
+        std::vector<Table const *> const supportedList{findSupportedList()};
+
+        char const *const requestedKey{std::getenv(environmentVariableName)};
+        if (requestedKey != nullptr and *requestedKey != '\0') {
+            for (Table const *const table : supportedList) if (std::strcmp(table->key, requestedKey) == 0) return *table;
+            SdlContext::warn(
+                "Ignoring kernel backend \"", requestedKey, "\" of ", environmentVariableName,
+                ", which is unknown, not compiled in, or not supported by this processor."
+            );
+        }
+
+        return *supportedList.back();
+    }
+}
+
+Project::KernelBackend::Table const &Project::KernelBackend::getSelected() {
+    static Table const &selected{choose()};
+    return selected;
+}
+
+Project::KernelBackend::Table const &Project::KernelBackend::getReference() { return baselineTable; }
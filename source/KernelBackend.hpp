@@ -0,0 +1,111 @@
+#ifndef KernelBackend_hpp
+#define KernelBackend_hpp true
+
+#include <array>
+#include "SdlContext.hpp"
+#include "HslaColor.hpp"
+#include "HueField.hpp"
+
+/*
+    The kernels that touch every pixel, which compute the rows of the hue field and convert hues to pixels,
+    are compiled once for every instruction set in one program, and the best one that the processor supports is used.
+
+    Each compilation of `KernelBackendTable.cpp` defines the table of one backend. The Makefile compiles it
+    with the compiler's flags for the baseline, and natively on x86 again with SSE4.1, AVX2, and AVX-512,
+    where it defines `PROJECT_KERNEL_DISPATCH`. Elsewhere the baseline is the only backend.
+*/
+
+namespace Project::KernelBackend {
+    // Compute a row of the hue field from `(startX, y)`, with exactly as many sinks, then sources, as the function was specialized for.
+    using SpecializedRowFunction = void (*)(
+        HueField::Phase *const row, int const width, float const startX, float const y, HueField::PointList const &pointList, float const hueScale
+    );
+
+    // Compute a row of the hue field from `(startX, y)` with any points, summing the distances into a scratch row of `width` floats first.
+    using RowFunction = void (*)(
+        HueField::Phase *const row,
+        int const width,
+        float const startX,
+        float const y,
+        HueField::PointList const &pointList,
+        float const hueScale,
+        float *const distanceSumList
+    );
+
+    // Sum the weighted distances to the points from `count` samples that are `stepX` apart along a row, starting at `(startX, y)`.
+    using SampleFunction = void (*)(
+        float *const sumList,
+        int const count,
+        float const startX,
+        float const stepX,
+        float const y,
+        HueField::PointList const &pointList
+    );
+
+    // Convert a row of sums of weighted distances to hue phases of the field.
+    using PhaseRowFunction = void (*)(HueField::Phase *const row, float const *const sumList, int const count, float const hueScale);
+
+    // Convert a row of hues to packed pixels (see `PixelKernel::convertHueRow`).
+    using ConvertFunction = void (*)(
+        float const *const hueList,
+        Uint32 *const pixelList,
+        int const count,
+        float const saturation,
+        float const luminance,
+        float const alpha,
+        SDL_PixelFormat const &format
+    );
+
+    // Look up a row of pixels, 2 or 4 bytes wide, in a table of `PixelKernel::HueTable::size` pixels.
+    using RowWriter = void (*)(
+        Uint32 const *const pixelTable, HueField::Phase const *const phaseList, void *const pixelRow, int const count, HueField::Phase const hueOffset
+    );
+
+    /**
+     * @brief Kernels of one backend, compiled for one instruction set.
+     */
+    struct Table {
+        // Value of the environment variable that asks for this backend.
+        char const *key;
+
+        // Name of the instruction set, for reports.
+        char const *name;
+
+        // Specialized row function for every number of sinks and number of sources, indexed in that order.
+        std::array<std::array<SpecializedRowFunction, HueField::maxSpecializedPointCount + 1u>, HueField::maxSpecializedPointCount + 1u>
+            specializedRowTable;
+
+        RowFunction computeRow;
+        SampleFunction sampleDistanceSums;
+        PhaseRowFunction convertSumRow;
+        ConvertFunction convertHueRow;
+        RowWriter writeRow16, writeRow32;
+    };
+
+    // Environment variable that overrides the choice of backend with the key of another, such as "baseline" or "avx2".
+    inline constexpr char environmentVariableName[]{"COLORFUL_DISPLAY_KERNEL"};
+
+    /**
+     * @brief Get the backend that renders frames.
+     * 
+     * @note On the first call, the backend is chosen: the one asked for by the environment variable if the processor supports it,
+     * and otherwise the one of the newest instruction set that the processor supports.
+     */
+    extern Table const &getSelected();
+
+    /**
+     * @brief Get the backend compiled with the baseline flags, which every processor that runs the program supports.
+     * 
+     * @note It is the reference that the other backends are verified against. It is scalar unless the program was compiled
+     * for a newer instruction set than the compiler's default.
+     */
+    extern Table const &getReference();
+
+    // Backends, defined by the compilations of `KernelBackendTable.cpp`.
+    extern Table const baselineTable;
+    #ifdef PROJECT_KERNEL_DISPATCH
+    extern Table const sse4_1Table, avx2Table, avx512Table;
+    #endif
+}
+
+#endif
@@ -0,0 +1,329 @@
+#include "KernelBackend.hpp"
+#include "PixelKernel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+/*
+    This file is compiled once for every backend, with the flags of its instruction set (see `KernelBackend.hpp`).
+    `PROJECT_KERNEL_BACKEND` names the backend, and is undefined for the baseline.
+
+    Everything but the table has internal linkage, and with optimization, the functions of the standard library that are used here
+    are inlined, so the linker has no function compiled for a newer instruction set to share with the rest of the program.
+*/
+
+#ifndef PROJECT_KERNEL_BACKEND
+#define PROJECT_KERNEL_BACKEND baseline
+#endif
+
+/*
+    The conversion uses the branch-free form of HSL to RGB:
+
+        a = S * min(L, 1 - L)
+        k(n) = (n + H / 30) mod 12
+        f(n) = L - a * max(-1, min(k(n) - 3, 9 - k(n), 1))
+
+    where the red, green, and blue channels are f(0), f(8), and f(4).
+    This gives the same colors as the six-way branch of `makeRgbaColor`.
+*/
+
+namespace Project::KernelBackend {
+    namespace {
+        /**
+         * @brief Convert a hue in degrees to a phase of the field, through a 32-bit integer so that the conversion is vectorized.
+         * 
+         * @note Hues are clamped to 2000 turns around zero first. Float hues that far out are off by more than a degree anyway.
+         */
+        inline HueField::Phase toFieldPhase(float const hue) {
+            static constexpr float stepsPerDegree{static_cast<float>(HueField::phasePerDegree)};
+            static constexpr float limit{2000.0f * 360.0f};
+            return static_cast<HueField::Phase>(static_cast<std::int32_t>(std::min(std::max(hue, -limit), limit) * stepsPerDegree));
+        }
+
+        /**
+         * @return sum of the distances from `(x, y)` to the points, for every point index in the sequence
+         */
+        template <std::size_t pointCount, std::size_t... index>
+        inline float sumDistances(
+            [[maybe_unused]] float const x,
+            [[maybe_unused]] std::array<float, pointCount> const &xList,
+            [[maybe_unused]] std::array<float, pointCount> const &dySquaredList,
+            std::index_sequence<index...>
+        ) {
+            return (0.0f + ... + std::sqrt((x - xList[index]) * (x - xList[index]) + dySquaredList[index]));
+        }
+
+        /**
+         * @brief Compute a row of a field with exactly `sinkCount` sinks followed by `sourceCount` sources.
+         * 
+         * @note The points are moved by `startX` once per row, so the pixels are counted from zero.
+         * 
+         * @note The loops over the points are unrolled and the signs of the points are constants,
+         * so the loop over the pixels of the row has no branches and is vectorized, wrapping included.
+         */
+        template <std::size_t sinkCount, std::size_t sourceCount>
+        void computeRowSpecialized(
+            HueField::Phase *const row,
+            int const width,
+            float const startX,
+            float const y,
+            HueField::PointList const &pointList,
+            float const hueScale
+        ) {
+            std::array<float, sinkCount> sinkXList, sinkDySquaredList;
+            std::array<float, sourceCount> sourceXList, sourceDySquaredList;
+            for (std::size_t index{0u}; index < sinkCount; ++index) {
+                float const dy{y - pointList.yList[index]};
+                sinkXList[index] = pointList.xList[index] - startX;
+                sinkDySquaredList[index] = dy * dy;
+            }
+            for (std::size_t index{0u}; index < sourceCount; ++index) {
+                float const dy{y - pointList.yList[sinkCount + index]};
+                sourceXList[index] = pointList.xList[sinkCount + index] - startX;
+                sourceDySquaredList[index] = dy * dy;
+            }
+
+            for (int x{0}; x < width; ++x) {
+                float const pixelX{static_cast<float>(x)};
+                row[x] = toFieldPhase(hueScale * (
+                    sumDistances(pixelX, sinkXList, sinkDySquaredList, std::make_index_sequence<sinkCount>()) -
+                    sumDistances(pixelX, sourceXList, sourceDySquaredList, std::make_index_sequence<sourceCount>())
+                ));
+            }
+        }
+
+        template <std::size_t sinkCount, std::size_t... sourceCount>
+        constexpr std::array<SpecializedRowFunction, sizeof...(sourceCount)> makeRowFunctionList(std::index_sequence<sourceCount...>) {
+            return {&computeRowSpecialized<sinkCount, sourceCount>...};
+        }
+
+        template <std::size_t... sinkCount>
+        constexpr auto makeRowFunctionTable(std::index_sequence<sinkCount...>) {
+            return std::array{makeRowFunctionList<sinkCount>(std::make_index_sequence<HueField::maxSpecializedPointCount + 1u>())...};
+        }
+
+        // Specialized kernel for every number of sinks and number of sources, indexed in that order.
+        inline constexpr auto rowFunctionTable{makeRowFunctionTable(std::make_index_sequence<HueField::maxSpecializedPointCount + 1u>())};
+
+        /**
+         * @brief Compute a row of a field with any points, one point at a time, so that the loop over the row can be vectorized.
+         */
+        void computeRowGeneric(
+            HueField::Phase *const row,
+            int const width,
+            float const startX,
+            float const y,
+            HueField::PointList const &pointList,
+            float const hueScale,
+            float *const sumRow
+        ) {
+            std::size_t const pointCount{pointList.size()};
+            float const *const xList{pointList.xList.data()};
+            float const *const yList{pointList.yList.data()};
+            float const *const weightList{pointList.weightList.data()};
+
+            std::fill(sumRow, sumRow + width, 0.0f);
+            for (std::size_t pointIndex{0u}; pointIndex < pointCount; ++pointIndex) {
+                float const pointX{xList[pointIndex] - startX};
+                float const dySquared{(y - yList[pointIndex]) * (y - yList[pointIndex])};
+                float const weight{weightList[pointIndex]};
+                for (int x{0}; x < width; ++x) {
+                    float const dx{static_cast<float>(x) - pointX};
+                    sumRow[x] += weight * std::sqrt(dx * dx + dySquared);
+                }
+            }
+
+            // Wrap once per pixel.
+            for (int x{0}; x < width; ++x) row[x] = toFieldPhase(hueScale * sumRow[x]);
+        }
+
+        void sampleDistanceSums(
+            float *const sumList,
+            int const count,
+            float const startX,
+            float const stepX,
+            float const y,
+            HueField::PointList const &pointList
+        ) {
+            std::size_t const pointCount{pointList.size()};
+            float const *const xList{pointList.xList.data()};
+            float const *const yList{pointList.yList.data()};
+            float const *const weightList{pointList.weightList.data()};
+
+            std::fill(sumList, sumList + count, 0.0f);
+            for (std::size_t pointIndex{0u}; pointIndex < pointCount; ++pointIndex) {
+                float const offsetX{startX - xList[pointIndex]};
+                float const dySquared{(y - yList[pointIndex]) * (y - yList[pointIndex])};
+                float const weight{weightList[pointIndex]};
+                for (int index{0}; index < count; ++index) {
+                    float const dx{offsetX + static_cast<float>(index) * stepX};
+                    sumList[index] += weight * std::sqrt(dx * dx + dySquared);
+                }
+            }
+        }
+
+        void convertSumRow(HueField::Phase *const row, float const *const sumList, int const count, float const hueScale) {
+            for (int x{0}; x < count; ++x) row[x] = toFieldPhase(hueScale * sumList[x]);
+        }
+
+
+        struct Parameters {
+            float luminance, chromaHalf;
+            Uint32 alphaBits;
+            int redLoss, greenLoss, blueLoss;
+            int redShift, greenShift, blueShift;
+
+            Parameters(float const saturation, float const luminance, float const alpha, SDL_PixelFormat const &format):
+                luminance{luminance},
+                chromaHalf{saturation * std::min(luminance, 1.0f - luminance)},
+                alphaBits{
+                    (static_cast<Uint32>(static_cast<Uint8>(alpha * 0xFF) >> format.Aloss) << format.Ashift) & format.Amask
+                },
+                redLoss{format.Rloss}, greenLoss{format.Gloss}, blueLoss{format.Bloss},
+                redShift{format.Rshift}, greenShift{format.Gshift}, blueShift{format.Bshift}
+            {}
+        };
+
+        inline Uint32 channelOf(float const hueTwelfth, float const n, Parameters const &parameters) {
+            float k{n + hueTwelfth};
+            k -= 12.0f * std::floor(k * (1.0f / 12.0f));
+            float const t{std::max(-1.0f, std::min({k - 3.0f, 9.0f - k, 1.0f}))};
+            float const value{parameters.luminance - parameters.chromaHalf * t};
+            return static_cast<Uint32>(std::max(0.0f, value) * 255.0f);
+        }
+
+        void convertScalar(float const *const hueList, Uint32 *const pixelList, int const begin, int const end, Parameters const &parameters) {
+            for (int index{begin}; index < end; ++index) {
+                float const hueTwelfth{hueList[index] * (1.0f / 30.0f)};
+                pixelList[index] =
+                    ((channelOf(hueTwelfth, 0.0f, parameters) >> parameters.redLoss  ) << parameters.redShift  ) |
+                    ((channelOf(hueTwelfth, 8.0f, parameters) >> parameters.greenLoss) << parameters.greenShift) |
+                    ((channelOf(hueTwelfth, 4.0f, parameters) >> parameters.blueLoss ) << parameters.blueShift ) |
+                    parameters.alphaBits;
+            }
+        }
+
+        #if defined(__AVX2__)
+        inline __m256i channelOf(__m256 const hueTwelfth, float const n, Parameters const &parameters) {
+            __m256 k{_mm256_add_ps(_mm256_set1_ps(n), hueTwelfth)};
+            k = _mm256_sub_ps(k, _mm256_mul_ps(_mm256_set1_ps(12.0f), _mm256_floor_ps(_mm256_mul_ps(k, _mm256_set1_ps(1.0f / 12.0f)))));
+            __m256 t{_mm256_min_ps(_mm256_sub_ps(k, _mm256_set1_ps(3.0f)), _mm256_sub_ps(_mm256_set1_ps(9.0f), k))};
+            t = _mm256_max_ps(_mm256_set1_ps(-1.0f), _mm256_min_ps(t, _mm256_set1_ps(1.0f)));
+            __m256 const value{_mm256_sub_ps(_mm256_set1_ps(parameters.luminance), _mm256_mul_ps(_mm256_set1_ps(parameters.chromaHalf), t))};
+            return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(255.0f)));
+        }
+
+        inline __m256i pack(__m256i const channel, int const loss, int const shift) {
+            return _mm256_sll_epi32(_mm256_srl_epi32(channel, _mm_cvtsi32_si128(loss)), _mm_cvtsi32_si128(shift));
+        }
+
+        void convert(float const *const hueList, Uint32 *const pixelList, int const count, Parameters const &parameters) {
+            static constexpr int width{8};
+            __m256i const alphaBits{_mm256_set1_epi32(static_cast<int>(parameters.alphaBits))};
+            int index{0};
+            for (; index + width <= count; index += width) {
+                __m256 const hueTwelfth{_mm256_mul_ps(_mm256_loadu_ps(hueList + index), _mm256_set1_ps(1.0f / 30.0f))};
+                __m256i pixel{alphaBits};
+                pixel = _mm256_or_si256(pixel, pack(channelOf(hueTwelfth, 0.0f, parameters), parameters.redLoss, parameters.redShift));
+                pixel = _mm256_or_si256(pixel, pack(channelOf(hueTwelfth, 8.0f, parameters), parameters.greenLoss, parameters.greenShift));
+                pixel = _mm256_or_si256(pixel, pack(channelOf(hueTwelfth, 4.0f, parameters), parameters.blueLoss, parameters.blueShift));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(pixelList + index), pixel);
+            }
+            convertScalar(hueList, pixelList, index, count, parameters);
+        }
+        #elif defined(__SSE4_1__)
+        inline __m128i channelOf(__m128 const hueTwelfth, float const n, Parameters const &parameters) {
+            __m128 k{_mm_add_ps(_mm_set1_ps(n), hueTwelfth)};
+            k = _mm_sub_ps(k, _mm_mul_ps(_mm_set1_ps(12.0f), _mm_floor_ps(_mm_mul_ps(k, _mm_set1_ps(1.0f / 12.0f)))));
+            __m128 t{_mm_min_ps(_mm_sub_ps(k, _mm_set1_ps(3.0f)), _mm_sub_ps(_mm_set1_ps(9.0f), k))};
+            t = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(t, _mm_set1_ps(1.0f)));
+            __m128 const value{_mm_sub_ps(_mm_set1_ps(parameters.luminance), _mm_mul_ps(_mm_set1_ps(parameters.chromaHalf), t))};
+            return _mm_cvttps_epi32(_mm_mul_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(255.0f)));
+        }
+
+        inline __m128i pack(__m128i const channel, int const loss, int const shift) {
+            return _mm_sll_epi32(_mm_srl_epi32(channel, _mm_cvtsi32_si128(loss)), _mm_cvtsi32_si128(shift));
+        }
+
+        void convert(float const *const hueList, Uint32 *const pixelList, int const count, Parameters const &parameters) {
+            static constexpr int width{4};
+            __m128i const alphaBits{_mm_set1_epi32(static_cast<int>(parameters.alphaBits))};
+            int index{0};
+            for (; index + width <= count; index += width) {
+                __m128 const hueTwelfth{_mm_mul_ps(_mm_loadu_ps(hueList + index), _mm_set1_ps(1.0f / 30.0f))};
+                __m128i pixel{alphaBits};
+                pixel = _mm_or_si128(pixel, pack(channelOf(hueTwelfth, 0.0f, parameters), parameters.redLoss, parameters.redShift));
+                pixel = _mm_or_si128(pixel, pack(channelOf(hueTwelfth, 8.0f, parameters), parameters.greenLoss, parameters.greenShift));
+                pixel = _mm_or_si128(pixel, pack(channelOf(hueTwelfth, 4.0f, parameters), parameters.blueLoss, parameters.blueShift));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pixelList + index), pixel);
+            }
+            convertScalar(hueList, pixelList, index, count, parameters);
+        }
+        #else
+        void convert(float const *const hueList, Uint32 *const pixelList, int const count, Parameters const &parameters) {
+            convertScalar(hueList, pixelList, 0, count, parameters);
+        }
+        #endif
+
+        void convertHueRow(
+            float const *const hueList,
+            Uint32 *const pixelList,
+            int const count,
+            float const saturation,
+            float const luminance,
+            float const alpha,
+            SDL_PixelFormat const &format
+        ) {
+            convert(hueList, pixelList, count, Parameters(saturation, luminance, alpha, format));
+        }
+
+        /**
+         * @brief Write a row of pixels that are stored as `Pixel`, which is as wide as the pixels of the format.
+         */
+        template <typename Pixel>
+        void writeRow(
+            Uint32 const *const pixelTable, HueField::Phase const *const phaseList, void *const pixelRow, int const count, HueField::Phase const hueOffset
+        ) {
+            static constexpr int indexShift{16 - PixelKernel::HueTable::indexBitCount};
+            Pixel *const pixelList{static_cast<Pixel *>(pixelRow)};
+            for (int index{0}; index < count; ++index) {
+                // The table holds two turns, so the sum of a phase and the offset, which can pass a turn, needs no wrapping.
+                pixelList[index] = static_cast<Pixel>(pixelTable[(static_cast<unsigned>(phaseList[index]) + hueOffset) >> indexShift]);
+            }
+        }
+
+        #if defined(__AVX512F__)
+        inline constexpr char instructionSetName[]{"AVX-512"};
+        #elif defined(__AVX2__)
+        inline constexpr char instructionSetName[]{"AVX2"};
+        #elif defined(__SSE4_1__)
+        inline constexpr char instructionSetName[]{"SSE4.1"};
+        #else
+        inline constexpr char instructionSetName[]{"scalar"};
+        #endif
+    }
+}
+
+#define PROJECT_KERNEL_STRINGIFY(token) #token
+#define PROJECT_KERNEL_STRING(token) PROJECT_KERNEL_STRINGIFY(token)
+#define PROJECT_KERNEL_CONCATENATE(left, right) left##right
+#define PROJECT_KERNEL_TABLE(backend) PROJECT_KERNEL_CONCATENATE(backend, Table)
+
+Project::KernelBackend::Table const Project::KernelBackend::PROJECT_KERNEL_TABLE(PROJECT_KERNEL_BACKEND){
+    PROJECT_KERNEL_STRING(PROJECT_KERNEL_BACKEND),
+    instructionSetName,
+    rowFunctionTable,
+    &computeRowGeneric,
+    &sampleDistanceSums,
+    &convertSumRow,
+    &convertHueRow,
+    &writeRow<Uint16>,
+    &writeRow<Uint32>
+};
@@ -0,0 +1,314 @@
+#include "Microbenchmark.hpp"
+#include "project_utility.hpp"
+#include "project_print.hpp"
+#include "HslaColor.hpp"
+#include "HueField.hpp"
+#include "CanvasRenderer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace Project::Microbenchmark {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        struct Result {
+            std::string name;
+            double nanoseconds;
+        };
+
+        // Number of inputs that each primitive cycles through, enough to defeat branch prediction.
+        constexpr std::size_t inputCount{4096u};
+
+        // Runs of each benchmark; the fastest counts.
+        constexpr int runCount{7};
+
+        // Shortest time in nanoseconds that a run lasts.
+        constexpr std::int64_t minimumRunTime{10'000'000};
+
+        // Results are folded into this, so that the compiler cannot drop the calls.
+        volatile double sink;
+
+        /**
+         * @brief Time a function over a list of inputs.
+         * 
+         * @param function called with every input; the result is converted to `double` and kept
+         * @return nanoseconds per call, the fastest over the runs
+         */
+        template <typename InputT, typename FunctionT>
+        double timeCalls(std::vector<InputT> const &inputList, FunctionT const &function) {
+            double fastest{std::numeric_limits<double>::infinity()};
+            for (int run{0}; run < runCount; ++run) {
+                long long callCount{0};
+                double total{0.0};
+                auto const startTime{Clock::now()};
+                std::int64_t elapsed{0};
+                do {
+                    for (InputT const &input : inputList) total += static_cast<double>(function(input));
+                    callCount += static_cast<long long>(inputList.size());
+                    elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count();
+                } while (elapsed < minimumRunTime);
+                sink = sink + total;
+                fastest = std::min(fastest, static_cast<double>(elapsed) / static_cast<double>(callCount));
+            }
+            return fastest;
+        }
+
+        template <typename T>
+        std::vector<T> makeUniformList(std::mt19937 &generator, T const minimum, T const maximum) {
+            std::uniform_real_distribution<T> distribution(minimum, maximum);
+            std::vector<T> list(inputCount);
+            for (T &value : list) value = distribution(generator);
+            return list;
+        }
+
+        // Sum of the channels, so that a color is kept as one number.
+        double sumChannels(SDL_Color const &color) { return color.r + color.g + color.b + color.a; }
+
+        void benchmarkColors(std::mt19937 &generator, std::vector<Result> &resultList) {
+            auto const uniformHueList{makeUniformList(generator, 0.0, 360.0)};
+
+            // Hues a hair away from the borders of the sectors of 60 degrees.
+            std::vector<double> sectorEdgeHueList(inputCount);
+            for (std::size_t index{0u}; index < inputCount; ++index) {
+                sectorEdgeHueList[index] = std::min(std::nextafter(360.0, 0.0), std::max(0.0,
+                    60.0 * static_cast<double>(index % 7u) + (index % 2u == 0u ? -1e-9 : 1e-9)
+                ));
+            }
+
+            std::vector<HslaColor> colorList(inputCount);
+            std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+            for (HslaColor &color : colorList) color = HslaColor(
+                unitDistribution(generator) * 360.0f, unitDistribution(generator), unitDistribution(generator), unitDistribution(generator)
+            );
+
+            resultList.push_back({"makeRgbaColor/double/uniform hue", timeCalls(uniformHueList, [](double const hue) {
+                return sumChannels(makeRgbaColor(hue));
+            })});
+            resultList.push_back({"makeRgbaColor/double/sector edge hue", timeCalls(sectorEdgeHueList, [](double const hue) {
+                return sumChannels(makeRgbaColor(hue));
+            })});
+            resultList.push_back({"HslaColor::toRgbaColor/uniform color", timeCalls(colorList, [](HslaColor const &color) {
+                return sumChannels(color.toRgbaColor());
+            })});
+
+            auto const percentageList{makeUniformList(generator, 0.0, 1.0)};
+            resultList.push_back({"HslaColor::getCyclicHue", timeCalls(percentageList, [](double const percentage) {
+                return HslaColor::getCyclicHue(200.0, percentage, 45.0);
+            })});
+        }
+
+        template <typename FloatT>
+        void benchmarkMath(std::mt19937 &generator, std::vector<Result> &resultList, char const *const typeName) {
+            static constexpr FloatT upperBound{360.0};
+            std::string const prefix{std::string("wrapValue<") + typeName + ">/"};
+
+            resultList.push_back({prefix + "in range", timeCalls(makeUniformList<FloatT>(generator, 0.0, upperBound), [](FloatT const value) {
+                return wrapValue(value, upperBound);
+            })});
+            resultList.push_back({prefix + "near range", timeCalls(makeUniformList<FloatT>(generator, -upperBound, 2.0 * upperBound), [](FloatT const value) {
+                return wrapValue(value, upperBound);
+            })});
+            resultList.push_back({prefix + "far out of range", timeCalls(makeUniformList<FloatT>(generator, -1e6, 1e6), [](FloatT const value) {
+                return wrapValue(value, upperBound);
+            })});
+
+            resultList.push_back({std::string("linearInterpolation<") + typeName + ">", timeCalls(makeUniformList<FloatT>(generator, 0.0, 1.0), [](FloatT const percentage) {
+                return linearInterpolation<FloatT>(percentage, -43.165, 54.4);
+            })});
+        }
+
+        /**
+         * @brief Fill a frame state at a time of the animation, with sinks spread over the canvas.
+         */
+        void fillFrameState(FrameState &state, double const time, int const width, int const height, int const sinkCount) {
+            SdlContext::computeAnimationFrameState(state, time, width, height);
+
+            // The sources come from the animation; put the sinks first, as interaction does.
+            HueField::PointList const sourceList{state.pointList};
+            state.pointList.clear();
+            for (int index{0}; index < sinkCount; ++index) {
+                float const angle{static_cast<float>(2.0 * pi * index / sinkCount + time * 0.001)};
+                state.pointList.add({
+                    static_cast<float>(width) * (0.5f + 0.4f * std::cos(angle)), static_cast<float>(height) * (0.5f + 0.4f * std::sin(angle))
+                }, /* sink */ +1.0f);
+            }
+            for (std::size_t index{0u}; index < sourceList.size(); ++index) state.pointList.add(
+                {sourceList.xList[index], sourceList.yList[index]}, sourceList.weightList[index]
+            );
+        }
+
+        void benchmarkHueField(std::vector<Result> &resultList) {
+            static constexpr int size{SdlContext::defaultCanvasBufferWidth};
+
+            for (int const sinkCount : {0, 2, 8}) {
+                HueField field(size, size);
+                FrameState state;
+
+                // Every call moves the points, so the field is recomputed.
+                std::vector<double> timeList(64u);
+                for (std::size_t index{0u}; index < timeList.size(); ++index) timeList[index] = 100.0 * static_cast<double>(index);
+
+                double const nanoseconds{timeCalls(timeList, [&](double const time) {
+                    fillFrameState(state, time, size, size, sinkCount);
+                    field.setInputs(state.pointList, state.hueScale, 0.0f);
+                    field.computeRows(0, size);
+                    return field.getRow(size / 2)[size / 2];
+                })};
+
+                resultList.push_back({
+                    "HueField::computeRows/exact/" + std::to_string(sinkCount + 4) + " points/per pixel", nanoseconds / (size * size)
+                });
+            }
+
+            // Many points on a large canvas, computed at every pixel and interpolated on the coarse grid.
+            static constexpr int largeSize{4 * size};
+            for (float const tolerance : {0.0f, 0.5f}) {
+                HueField field(largeSize, largeSize);
+                FrameState state;
+
+                std::vector<double> timeList(16u);
+                for (std::size_t index{0u}; index < timeList.size(); ++index) timeList[index] = 100.0 * static_cast<double>(index);
+
+                double const nanoseconds{timeCalls(timeList, [&](double const time) {
+                    fillFrameState(state, time, largeSize, largeSize, 60);
+                    field.setInputs(state.pointList, state.hueScale, 0.0f, 1, tolerance);
+                    field.computeRows(0, largeSize);
+                    return field.getRow(largeSize / 2)[largeSize / 2];
+                })};
+
+                resultList.push_back({
+                    std::string("HueField::computeRows/") + (tolerance > 0.0f ? "interpolated" : "exact") + '/' +
+                    std::to_string(largeSize) + 'x' + std::to_string(largeSize) + "/64 points/per pixel",
+                    nanoseconds / (largeSize * largeSize)
+                });
+            }
+        }
+
+        void benchmarkFrames(std::vector<Result> &resultList) {
+            std::unique_ptr<SDL_PixelFormat, decltype(&SDL_FreeFormat)> const pixelFormat(
+                SdlContext::check(SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888)), &SDL_FreeFormat
+            );
+
+            for (int const size : {135, 270, 540, 1080}) {
+                for (int const sinkCount : {0, 2, 8}) {
+                    CanvasRenderer renderer(size, size);
+                    FrameState state;
+                    std::vector<Uint32> pixelList(static_cast<std::size_t>(size) * static_cast<std::size_t>(size));
+
+                    std::vector<double> timeList(16u);
+                    for (std::size_t index{0u}; index < timeList.size(); ++index) timeList[index] = 100.0 * static_cast<double>(index);
+
+                    resultList.push_back({
+                        "frame/" + std::to_string(size) + 'x' + std::to_string(size) + '/' + std::to_string(sinkCount + 4) + " points",
+                        timeCalls(timeList, [&](double const time) {
+                            fillFrameState(state, time, size, size, sinkCount);
+                            renderer.render(state, *pixelFormat, pixelList.data(), size * static_cast<int>(sizeof(Uint32)), nullptr);
+                            return pixelList[pixelList.size() / 2u];
+                        })
+                    });
+                }
+            }
+        }
+
+        std::string toJson(std::vector<Result> const &resultList) {
+            std::ostringstream stream;
+            stream << "{\"unit\":\"ns\",\"results\":[\n";
+            for (std::size_t index{0u}; index < resultList.size(); ++index) {
+                stream << "{\"name\":\"" << resultList[index].name << "\",\"ns\":" << resultList[index].nanoseconds << '}';
+                stream << (index + 1u < resultList.size() ? ",\n" : "\n");
+            }
+            stream << "]}";
+            return stream.str();
+        }
+
+        /**
+         * @brief Read the results of a file written by `run`.
+         * 
+         * @note Only the layout that `toJson` writes is understood: one result per line, with the name before the time.
+         */
+        std::map<std::string, double> readResults(std::istream &input) {
+            static constexpr std::string_view nameKey{"\"name\":\""}, timeKey{"\"ns\":"};
+
+            std::map<std::string, double> resultMap;
+            for (std::string line; std::getline(input, line);) {
+                std::size_t const nameStart{line.find(nameKey)};
+                if (nameStart == std::string::npos) continue;
+                std::size_t const nameEnd{line.find('"', nameStart + nameKey.size())};
+                std::size_t const timeStart{line.find(timeKey, nameEnd)};
+                if (nameEnd == std::string::npos or timeStart == std::string::npos) continue;
+                resultMap[line.substr(nameStart + nameKey.size(), nameEnd - nameStart - nameKey.size())] =
+                    std::atof(line.c_str() + timeStart + timeKey.size());
+            }
+            return resultMap;
+        }
+
+        /**
+         * @brief Print how every result compares with its baseline.
+         * 
+         * @return whether no result is slower than its baseline by more than the threshold
+         */
+        bool compare(std::vector<Result> const &resultList, std::map<std::string, double> const &baselineMap) {
+            bool isWithinThreshold{true};
+            for (Result const &result : resultList) {
+                auto const baseline{baselineMap.find(result.name)};
+                if (baseline == baselineMap.end() or baseline->second <= 0.0) {
+                    std::cerr << result.name << ": no baseline\n";
+                    continue;
+                }
+                double const change{result.nanoseconds / baseline->second - 1.0};
+                bool const isRegression{change > regressionThreshold};
+                isWithinThreshold = isWithinThreshold and not isRegression;
+                std::cerr
+                    << result.name << ": " << baseline->second << " ns -> " << result.nanoseconds << " ns ("
+                    << (change >= 0.0 ? "+" : "") << change * 100.0 << "%)" << (isRegression ? " REGRESSION" : "") << '\n';
+            }
+            return isWithinThreshold;
+        }
+    }
+}
+
+int Project::Microbenchmark::run(std::string const &outputPath, std::string const &baselinePath) {
+    std::map<std::string, double> baselineMap;
+    if (not baselinePath.empty()) {
+        std::ifstream baselineFile(baselinePath);
+        if (not baselineFile) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Failed to open \"%s\" for reading.", baselinePath.c_str());
+            return EXIT_FAILURE;
+        }
+        baselineMap = readResults(baselineFile);
+    }
+
+    // The same inputs in every run.
+    std::mt19937 generator(0x5EEDu);
+
+    std::vector<Result> resultList;
+    benchmarkColors(generator, resultList);
+    benchmarkMath<float>(generator, resultList, "float");
+    benchmarkMath<double>(generator, resultList, "double");
+    benchmarkHueField(resultList);
+    benchmarkFrames(resultList);
+
+    std::string const json{toJson(resultList)};
+    if (outputPath == "-") {
+        println(json);
+    } else {
+        std::ofstream file(outputPath);
+        if (not (file << json << '\n')) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Failed to write the results to \"%s\".", outputPath.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (baselinePath.empty()) return EXIT_SUCCESS;
+    return compare(resultList, baselineMap) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,26 @@
+#ifndef Microbenchmark_hpp
+#define Microbenchmark_hpp true
+
+#include <string>
+
+namespace Project::Microbenchmark {
+    /**
+     * @brief Time the color and math primitives, the hue field, and whole frames, each in isolation, then write the results as JSON.
+     * 
+     * @note Each primitive is timed over several distributions of inputs, such as hues in range and far out of range.
+     * Each result is the fastest of several runs, in nanoseconds per call, so that it is stable between runs.
+     * Frames are rendered on the calling thread alone, at several canvas sizes and numbers of points.
+     * 
+     * @note The JSON has one result per line, so that results can be compared line by line too.
+     * 
+     * @param outputPath file to write the results to, or "-" for the standard output
+     * @param baselinePath results of an earlier run to compare against, or empty for no comparison
+     * @return exit status for `main`; failure if a result is more than `regressionThreshold` slower than its baseline
+     */
+    extern int run(std::string const &outputPath, std::string const &baselinePath);
+
+    // Largest slowdown against the baseline that is not a regression, as a fraction.
+    inline constexpr double regressionThreshold{0.10};
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include "PixelKernel.hpp"
+#include "KernelBackend.hpp"
+
+#include <algorithm>
+
+void Project::PixelKernel::convertHueRow(
+    float const *const hueList,
+    Uint32 *const pixelList,
+    int const count,
+    float const saturation,
+    float const luminance,
+    float const alpha,
+    SDL_PixelFormat const &format
+) {
+    KernelBackend::getSelected().convertHueRow(hueList, pixelList, count, saturation, luminance, alpha, format);
+}
+
+char const *Project::PixelKernel::getInstructionSetName() { return KernelBackend::getSelected().name; }
+
+bool Project::PixelKernel::isSupportedFormat(Uint32 const format) {
+    return
+        format != SDL_PIXELFORMAT_UNKNOWN and not SDL_ISPIXELFORMAT_FOURCC(format) and SDL_ISPIXELFORMAT_PACKED(format) and
+        (SDL_BYTESPERPIXEL(format) == 2u or SDL_BYTESPERPIXEL(format) == 4u);
+}
+
+Uint32 Project::PixelKernel::choosePixelFormat(Uint32 const *const formatList, int const count) {
+    static constexpr std::array<Uint32, 5u> preferredFormatList{
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGBX8888, SDL_PIXELFORMAT_RGB565
+    };
+
+    Uint32 const *const formatListEnd{formatList + std::max(count, 0)};
+    for (Uint32 const format : preferredFormatList) {
+        if (std::find(formatList, formatListEnd, format) != formatListEnd) return format;
+    }
+    Uint32 const *const supportedFormat{std::find_if(formatList, formatListEnd, &isSupportedFormat)};
+    return supportedFormat != formatListEnd ? *supportedFormat : SDL_PIXELFORMAT_ARGB8888;
+}
+
+void Project::PixelKernel::HueTable::update(
+    float const saturation,
+    float const luminance,
+    float const alpha,
+    SDL_PixelFormat const &format
+) {
+    if (
+        saturation == cachedSaturation and luminance == cachedLuminance and alpha == cachedAlpha and format.format == cachedFormat
+    ) return;
+
+    cachedSaturation = saturation;
+    cachedLuminance = luminance;
+    cachedAlpha = alpha;
+    KernelBackend::Table const &kernels{backend != nullptr ? *backend : KernelBackend::getSelected()};
+    if (format.format != cachedFormat) {
+        cachedFormat = format.format;
+        rowWriter = format.BytesPerPixel == 2u ? kernels.writeRow16 : kernels.writeRow32;
+    }
+
+    std::array<float, size> hueList;
+    for (int index{0}; index < size; ++index) {
+        hueList[static_cast<std::size_t>(index)] = (static_cast<float>(index) + 0.5f) * (360.0f / static_cast<float>(size));
+    }
+    kernels.convertHueRow(hueList.data(), pixelTable.data(), size, saturation, luminance, alpha, format);
+    std::copy(pixelTable.begin(), pixelTable.begin() + size, pixelTable.begin() + size);
+}
@@ -0,0 +1,105 @@
+#ifndef PixelKernel_hpp
+#define PixelKernel_hpp true
+
+#include <array>
+#include "SdlContext.hpp"
+#include "HslaColor.hpp"
+#include "KernelBackend.hpp"
+
+namespace Project::PixelKernel {
+    /**
+     * @brief Convert a row of hues to packed pixels in one call.
+     * 
+     * @note Saturation, luminance, and alpha are the same for the whole row.
+     * The conversion has no branches per pixel, and is vectorized with the instruction set of the selected kernel backend:
+     * AVX2 or SSE4.1 (AVX-512 uses the AVX2 conversion).
+     * 
+     * @param hueList hues in degrees; any value is wrapped into [0, 360)
+     * @param pixelList output pixels, packed in the layout of `format`
+     * @param count number of pixels in the row
+     * @param format layout of the output pixels
+     */
+    extern void convertHueRow(
+        float const *const hueList,
+        Uint32 *const pixelList,
+        int const count,
+        float const saturation,
+        float const luminance,
+        float const alpha,
+        SDL_PixelFormat const &format
+    );
+
+    /**
+     * @return name of the instruction set of the selected kernel backend, which `convertHueRow` and `HueTable` use
+     */
+    extern char const *getInstructionSetName();
+
+    /**
+     * @return whether `HueTable` can write pixels of a format: packed, with 2 or 4 bytes per pixel
+     */
+    extern bool isSupportedFormat(Uint32 const format);
+
+    /**
+     * @brief Choose the format of the canvas texture from the formats that a renderer supports.
+     * 
+     * @note The common formats are preferred, in the order ARGB8888, ABGR8888, RGB888, RGBX8888, and RGB565,
+     * then any other supported format. If there is none, ARGB8888 is returned, which SDL converts when uploading.
+     * 
+     * @param formatList formats that the renderer supports, best first
+     * @param count number of formats
+     */
+    extern Uint32 choosePixelFormat(Uint32 const *const formatList, int const count);
+
+    class HueTable;
+}
+
+/**
+ * @brief Table from quantized hue straight to a packed pixel, for a fixed saturation, luminance, alpha, and pixel format.
+ * 
+ * @note Each entry holds the color at the center of its hue step,
+ * so a looked-up color is at most half a step (about 0.044 degrees) away from the exact color.
+ */
+class Project::PixelKernel::HueTable {
+  public:
+    // The top bits of a hue phase are the index of its entry.
+    static constexpr int indexBitCount{12};
+    static constexpr int size{1 << indexBitCount};
+
+    /**
+     * @brief Rebuild the table if the saturation, luminance, alpha, or pixel format changed since the last build.
+     * 
+     * @note The writer of `convertRow` is chosen here when the format changes, by the number of bytes per pixel.
+     * The format must be supported (see `isSupportedFormat`).
+     */
+    void update(float const saturation, float const luminance, float const alpha, SDL_PixelFormat const &format);
+
+    /**
+     * @brief Build and look up the table with the kernels of a backend. Must be called before the first `update`.
+     * 
+     * @param value backend, or null for `KernelBackend::getSelected()`
+     */
+    void setBackend(KernelBackend::Table const *const value) { backend = value; }
+
+    /**
+     * @brief Convert a row of phases of the hue field, rotated by a phase, to packed pixels with one table load per pixel.
+     * 
+     * @note The table holds two turns of hue, so the sum of a phase and the offset, up to two turns, is looked up without wrapping,
+     * and the loop has no floating point.
+     * 
+     * @param pixelRow first pixel of the row, in the format of the last `update`
+     * @param hueOffset phase to add to every phase
+     */
+    void convertRow(HueField::Phase const *const phaseList, void *const pixelRow, int const count, HueField::Phase const hueOffset=0u) const {
+      rowWriter(pixelTable.data(), phaseList, pixelRow, count, hueOffset);
+    }
+
+  private:
+    // Pixels packed in the low bits, whatever the width of the format. The second turn repeats the first.
+    std::array<Uint32, 2 * size> pixelTable{};
+    KernelBackend::RowWriter rowWriter{nullptr};
+    KernelBackend::Table const *backend{nullptr};
+    float cachedSaturation{-1.0f}, cachedLuminance{-1.0f}, cachedAlpha{-1.0f};
+    Uint32 cachedFormat{SDL_PIXELFORMAT_UNKNOWN};
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include "RenderThread.hpp"
+
+Project::RenderThread::RenderThread(SDL_PixelFormat const &format, WorkerPool *const workerPoolValue):
+    pixelFormat(format),
+    workerPool{workerPoolValue},
+    canvasRenderer(SdlContext::defaultCanvasBufferWidth, SdlContext::defaultCanvasBufferHeight),
+    thread(&RenderThread::loop, this)
+{}
+
+Project::RenderThread::~RenderThread() {
+    {
+        std::lock_guard const lock(mutex);
+        isStopping = true;
+    }
+    jobCondition.notify_one();
+    thread.join();
+}
+
+void Project::RenderThread::submit(FrameState const &state, int const width, int const height) {
+    Job &job = jobBuffer.getWriteSlot();
+    job.state = state;
+    job.width = width;
+    job.height = height;
+    jobBuffer.publish();
+
+    {
+        std::lock_guard const lock(mutex);
+        hasJob = true;
+    }
+    jobCondition.notify_one();
+}
+
+Project::RenderThread::Frame const *Project::RenderThread::takeFrame() {
+    return frameBuffer.take() ? &frameBuffer.getReadSlot() : nullptr;
+}
+
+void Project::RenderThread::loop() {
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            jobCondition.wait(lock, [this]() -> bool { return hasJob or isStopping; });
+            if (isStopping) return;
+            hasJob = false;
+        }
+
+        if (not jobBuffer.take()) continue;
+        Job const &job = jobBuffer.getReadSlot();
+
+        if (canvasRenderer.getWidth() != job.width or canvasRenderer.getHeight() != job.height) {
+            canvasRenderer.resize(job.width, job.height);
+        }
+
+        Frame &frame = frameBuffer.getWriteSlot();
+        frame.width = job.width;
+        frame.height = job.height;
+        int const rowLength{(job.width * pixelFormat.BytesPerPixel + static_cast<int>(sizeof(Uint32)) - 1) / static_cast<int>(sizeof(Uint32))};
+        frame.pitch = rowLength * static_cast<int>(sizeof(Uint32));
+        frame.pixelList.resize(static_cast<std::size_t>(rowLength) * static_cast<std::size_t>(job.height));
+
+        Uint64 const startCount{SDL_GetPerformanceCounter()};
+        canvasRenderer.render(job.state, pixelFormat, frame.pixelList.data(), frame.pitch, workerPool);
+        frame.renderTime = static_cast<double>(SDL_GetPerformanceCounter() - startCount) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+
+        frameBuffer.publish();
+    }
+}
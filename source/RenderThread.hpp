@@ -0,0 +1,82 @@
+#ifndef RenderThread_hpp
+#define RenderThread_hpp true
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CanvasRenderer.hpp"
+#include "TripleBuffer.hpp"
+
+namespace Project {
+  class RenderThread;
+}
+
+/**
+ * @brief Thread that renders frames into CPU pixel buffers while the main thread handles events and presents.
+ * 
+ * @note The main thread submits a snapshot of the frame state each frame and takes the latest finished frame.
+ * Both directions go through lock-free triple buffers, so frame N + 1 is computed while frame N is uploaded and presented.
+ */
+class Project::RenderThread {
+  public:
+    /**
+     * @brief Pixels of a finished frame, packed in the pixel format of the render thread.
+     */
+    struct Frame {
+      std::vector<Uint32> pixelList;
+      int width{0}, height{0};
+
+      // Length of a row in bytes; rows of 2-byte pixels are padded to whole `Uint32`s.
+      int pitch{0};
+
+      // Time in milliseconds that the render thread took to render the frame.
+      double renderTime{0.0};
+    };
+
+    /**
+     * @param format layout of the pixels; copied
+     * @param workerPool threads that the render thread renders bands of rows with, or null to render alone
+     */
+    RenderThread(SDL_PixelFormat const &format, WorkerPool *const workerPool);
+    ~RenderThread();
+
+    RenderThread(RenderThread const &) = delete;
+    RenderThread &operator=(RenderThread const &) = delete;
+
+    /**
+     * @brief Hand a frame state to the render thread. (Main thread only.)
+     */
+    void submit(FrameState const &state, int const width, int const height);
+
+    /**
+     * @brief Take the latest finished frame. (Main thread only.)
+     * 
+     * @return the frame, or null if no frame finished since the last call
+     */
+    Frame const *takeFrame();
+
+  private:
+    struct Job {
+      FrameState state;
+      int width{0}, height{0};
+    };
+
+    SDL_PixelFormat pixelFormat;
+    WorkerPool *workerPool;
+    CanvasRenderer canvasRenderer;
+
+    TripleBuffer<Job> jobBuffer;
+    TripleBuffer<Frame> frameBuffer;
+
+    // Only for sleeping while there is no job; the jobs themselves do not go through the lock.
+    std::mutex mutex;
+    std::condition_variable jobCondition;
+    bool hasJob{false}, isStopping{false};
+
+    std::thread thread;
+
+    void loop();
+};
+
+#endif
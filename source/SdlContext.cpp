@@ -1,10 +1,21 @@
 #include <algorithm>
 #include <optional>
-#include <unordered_map>
 #include <array>
 #include "SdlContext.hpp"
 #include "HslaColor.hpp"
+#include "CanvasRenderer.hpp"
+#include "RenderThread.hpp"
+#include "TouchPointSet.hpp"
+#include "FrameScheduler.hpp"
+#include "StageTimer.hpp"
+#include "KernelBackend.hpp"
+#include "InputTrace.hpp"
+#include <ctime>
 #include <limits>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 namespace Project::SdlContext {
     SDL_Window *window = nullptr;
@@ -16,14 +27,50 @@ namespace Project::SdlContext {
     static Uint64 deltaTime{0u};
     static int windowWidth{430}, windowHeight{430};
 
+    static int canvasBufferWidth{defaultCanvasBufferWidth}, canvasBufferHeight{defaultCanvasBufferHeight};
+
     /*
-        This point represents the position on the canvas buffer, not the actual displayed window.
+        Size of the canvas buffer that was asked for.
+        With adaptive resolution, the actual size is this size times the canvas buffer scale.
+    */
+    static int requestedCanvasBufferWidth{defaultCanvasBufferWidth}, requestedCanvasBufferHeight{defaultCanvasBufferHeight};
+    static double canvasBufferScale{1.0};
+
+    // Frame time in milliseconds that adaptive resolution aims for, or zero if adaptive resolution is off.
+    static Uint64 targetFrameTime{0u};
+
+    /*
+        Time in milliseconds that the last frame kept the main loop busy, from handling the events through presenting.
+        Unlike the delta time, it leaves out the wait for the next frame, so adaptive resolution sees how long rendering takes.
+    */
+    static double busyFrameTime{0.0};
+
+    /*
+        With the pipeline, time in milliseconds that the render thread took for the latest finished frame of the current size,
+        and zero otherwise. The main thread only hands the frames over, so the slower of the two threads sets the frame rate.
+    */
+    static double pipelineRenderTime{0.0};
+
+    static void applyCanvasBufferSize(int const width, int const height);
+    static void adaptCanvasBufferSize();
+
+    /*
+        This point represents the position on the window as a fraction of the window's size,
+        so that it maps to the canvas buffer at any size of the canvas buffer.
         If this is null, then the user is not pressing the mouse button.
     */
     static std::optional<SDL_FPoint> mouse = std::nullopt;
 
     static float hueSummand{0.0f};
 
+    // Whether frames during interaction are coarse previews.
+    static bool progressiveIsEnabled{false};
+
+    // Side in pixels of the blocks that share one computed hue in interactive frames.
+    static int fieldStride{1};
+
+    static void updateFieldStride(bool const isInteracting);
+
     static inline constexpr double customExponential(double const percentage) {
         double const x{linearInterpolation(percentage, -43.165, 54.4)};
         return 4.9 * std::exp(0.07 * x);
@@ -36,15 +83,25 @@ namespace Project::SdlContext {
             hueSummand = std::min<float>(0.0f, hueSummand + customExponential(percentage));
     }
 
-    struct NumberedPoint : SDL_FPoint {
-        using NumberType = std::uint_least8_t;
-        /// @note I believe this field is unused, so this `struct NumberedPoint` is unnecessary; can just use `SDL_FPoint`.
-        NumberType number;
-        explicit constexpr NumberedPoint(SDL_FPoint const &point, std::uint_least8_t const number):
-            SDL_FPoint(point), number{number}
-        {}
-    };
-    static std::unordered_map<SDL_FingerID, NumberedPoint> fingerMap;
+    // Fingers that touch the window, at positions as fractions of the window's size.
+    static TouchPointSet touchPointSet;
+
+    // Whether the window is minimized or hidden, so that nothing is animated nor rendered.
+    static bool renderingIsPaused{false};
+
+    /*
+        Time in milliseconds and processor time in seconds (of every thread) at which rendering was last paused or resumed,
+        and the totals while rendering, to compare the processor use of a pause against.
+    */
+    static Uint64 pauseChangeTime{0u};
+    static std::clock_t pauseChangeClock{0};
+    static Uint64 renderingTime{0u};
+    static std::clock_t renderingClock{0};
+
+    static void setRenderingPaused(bool const isPaused);
+
+    template <typename PollEventT>
+    static bool updateInput(Uint64 const currentTime, PollEventT &&pollEvent);
 }
 
 /// @note I don't believe this function is used anywhere.
@@ -55,8 +112,14 @@ void Project::SdlContext::refreshCachedWindowSize() {
 Uint64 Project::SdlContext::getDeltaTime() { return deltaTime; }
 int Project::SdlContext::getWindowHeight() { return windowHeight; }
 int Project::SdlContext::getWindowWidth() { return windowWidth; }
+int Project::SdlContext::getCanvasBufferWidth() { return canvasBufferWidth; }
+int Project::SdlContext::getCanvasBufferHeight() { return canvasBufferHeight; }
 
 void Project::SdlContext::exitHandler() {
+    StageTimer::dump(/* only to file */ true);
+    InputTrace::stopRecording();
+    // Stop the render thread before the pixel format it renders with is freed.
+    setPipelineEnabled(false);
     if (window != nullptr) SDL_DestroyWindow(window);
     if (renderer != nullptr) SDL_DestroyRenderer(renderer);
     if (canvasBuffer != nullptr) SDL_DestroyTexture(canvasBuffer);
@@ -66,15 +129,20 @@ void Project::SdlContext::exitHandler() {
 }
 
 /**
+ * @brief Advance the clock, handle the events, and update the interaction state, which is the part of an iteration of the main loop
+ * before the frame is rendered.
+ * 
  * @note Not thread-safe.
+ * 
+ * @param currentTime time of this iteration in milliseconds
+ * @param pollEvent callable that takes an `SDL_Event &`, and fills it with the next event and returns true, or returns false if there is none
+ * @return whether this iteration renders a frame, which it does not while the window is hidden
  */
-void Project::SdlContext::mainLoop() {
+template <typename PollEventT>
+bool Project::SdlContext::updateInput(Uint64 const currentTime, PollEventT &&pollEvent) {
     // Time of the previous iteration.
     static Uint64 previousTime{0u};
 
-    // Get the time of this iteration.
-    Uint64 const currentTime{SDL_GetTicks64()};
-
     // Get the change in time.
     deltaTime = currentTime - previousTime;
 
@@ -84,12 +152,14 @@ void Project::SdlContext::mainLoop() {
 
     static double mousePowerLevelPercentage{0.0};
 
-    static SDL_Event event;
+    SDL_Event event;
     // Handle events.
     /*
         This is the switch statement of greatness.
     */
-    while (SDL_PollEvent(&event)) switch (event.type) {
+    std::optional<StageTimer::Scope> eventsTimer;
+    if (not renderingIsPaused) eventsTimer.emplace(StageTimer::Stage::events);
+    while (pollEvent(event)) switch (event.type) {
         case SDL_KEYDOWN: switch (event.key.keysym.sym) {
             case SDLK_BACKQUOTE:
                 // "Real" fullscreen is buggy in the browser.
@@ -102,16 +172,16 @@ void Project::SdlContext::mainLoop() {
             case SDLK_ESCAPE:
                 check(SDL_SetWindowFullscreen(window, 0u));
                 break;
+            case SDLK_t:
+                // Dump the stage timings.
+                StageTimer::dump();
+                break;
         } break;
         case SDL_MOUSEBUTTONDOWN: switch (event.button.button) {
             case SDL_BUTTON_LEFT:
                 mouse = SDL_FPoint{
-                    linearInterpolation<float>(
-                        static_cast<float>(event.button.x) / static_cast<float>(windowWidth), 0.0f, canvasBufferWidth
-                    ),
-                    linearInterpolation<float>(
-                        static_cast<float>(event.button.y) / static_cast<float>(windowHeight), 0.0f, canvasBufferHeight
-                    )
+                    static_cast<float>(event.button.x) / static_cast<float>(windowWidth),
+                    static_cast<float>(event.button.y) / static_cast<float>(windowHeight)
                 };
                 break;
             case SDL_BUTTON_MIDDLE:
@@ -123,12 +193,8 @@ void Project::SdlContext::mainLoop() {
         } break;
         case SDL_MOUSEMOTION:
             if (mouse.has_value()) mouse = {
-                linearInterpolation<float>(
-                    static_cast<float>(event.motion.x) / static_cast<float>(windowWidth), 0.0f, canvasBufferWidth
-                ),
-                linearInterpolation<float>(
-                    static_cast<float>(event.motion.y) / static_cast<float>(windowHeight), 0.0f, canvasBufferHeight
-                )
+                static_cast<float>(event.motion.x) / static_cast<float>(windowWidth),
+                static_cast<float>(event.motion.y) / static_cast<float>(windowHeight)
             };
             break;
         case SDL_MOUSEBUTTONUP: switch (event.button.button) {
@@ -145,29 +211,18 @@ void Project::SdlContext::mainLoop() {
         case SDL_MOUSEWHEEL:
             /* no operation; do nothing */;
             break;
-        case SDL_FINGERMOTION: {
-            auto const iter(fingerMap.find(event.tfinger.fingerId));
-            if (iter != fingerMap.end()) {
-                auto &point = iter->second;
-                point.x = event.tfinger.x * canvasBufferWidth;
-                point.y = event.tfinger.y * canvasBufferHeight;
-                break;
-            } else {
-                // If the finger identifier is not in the map, insert it into the map.
-                goto insertFingerIdentifierIntoMap;
+        case SDL_FINGERMOTION: case SDL_FINGERDOWN:
+            /*
+                Motion only overwrites the finger's latest position, and the points are read once per frame,
+                so any number of motion events in a frame cost one store each.
+                A finger that moves without having been put down is added too.
+            */
+            if (not touchPointSet.set(event.tfinger.fingerId, event.tfinger.x, event.tfinger.y) and event.type == SDL_FINGERDOWN) {
+                warn("Ignoring a finger, because ", TouchPointSet::capacity, " fingers already touch the window.");
             }
-        }
-        case SDL_FINGERDOWN:
-            insertFingerIdentifierIntoMap: fingerMap.emplace(
-                /* key */ event.tfinger.fingerId,
-                /* value */ NumberedPoint(
-                    SDL_FPoint{event.tfinger.x * canvasBufferWidth, event.tfinger.y * canvasBufferHeight},
-                    static_cast<NumberedPoint::NumberType>(fingerMap.size())
-                )
-            );
             break;
         case SDL_FINGERUP:
-            fingerMap.erase(event.tfinger.fingerId);
+            touchPointSet.erase(event.tfinger.fingerId);
             break;
         case SDL_MULTIGESTURE: if (std::fabs(event.mgesture.dDist/* pinch distance */) > 0.002f/* threshold */) {
             hueSummand += 27.25f * event.mgesture.dDist/* pinch distance */ * static_cast<float>(event.mgesture.numFingers);
@@ -177,13 +232,28 @@ void Project::SdlContext::mainLoop() {
                 windowWidth = event.window.data1;
                 windowHeight = event.window.data2;
                 break;
+            case SDL_WINDOWEVENT_MINIMIZED: case SDL_WINDOWEVENT_HIDDEN:
+                setRenderingPaused(true);
+                break;
+            // A window that gains focus is visible too, in case the window manager did not say that it was restored.
+            case SDL_WINDOWEVENT_RESTORED: case SDL_WINDOWEVENT_MAXIMIZED: case SDL_WINDOWEVENT_SHOWN: case SDL_WINDOWEVENT_FOCUS_GAINED:
+                setRenderingPaused(false);
+                break;
         } break;
         case SDL_QUIT:
             std::exit(EXIT_SUCCESS);
             break;
     }
 
-    if (mouse.has_value() or not fingerMap.empty() or mouseRightButtonIsPressed) {
+    // As this iteration's input is handled, update the previous time.
+    previousTime = currentTime;
+
+    // Neither animate nor render while hidden; the animation continues from the same point when the window shows again.
+    if (renderingIsPaused) return false;
+
+    bool const isInteracting{mouse.has_value() or not touchPointSet.empty() or mouseRightButtonIsPressed};
+
+    if (isInteracting) {
         decayRateTimerPercentage = 0.0;
     } else decayHueSummand(
         decayRateTimerPercentage = std::clamp(decayRateTimerPercentage + static_cast<double>(deltaTime) * 0.00005, 0.0, 1.0)
@@ -195,13 +265,57 @@ void Project::SdlContext::mainLoop() {
         mousePowerLevelPercentage = std::clamp(mousePowerLevelPercentage - static_cast<double>(deltaTime) * 0.00005, 0.0, 1.0);
     }
 
+    eventsTimer.reset();
+
+    updateFieldStride(isInteracting);
+
+    adaptCanvasBufferSize();
+
+    return true;
+}
+
+/**
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::mainLoop() {
+    #ifdef __EMSCRIPTEN__
+    // The browser calls this function every animation frame; skip the ones that come before the next deadline.
+    if (not FrameScheduler::isFrameDue()) return;
+    #endif
+
+    #ifndef __EMSCRIPTEN__
+    // While the window is hidden, sleep until an event comes, but wake up now and then anyway.
+    // (The browser stops calling the loop in hidden tabs by itself.)
+    if (renderingIsPaused) SDL_WaitEventTimeout(nullptr/* leave the event in the queue */, 250/* milliseconds */);
+    #endif
+
+    // Iterations while the window is hidden are not frames.
+    std::optional<StageTimer::Scope> frameTimer;
+    if (not renderingIsPaused) frameTimer.emplace(StageTimer::Stage::frame);
+
+    Uint64 const busyStartCount{SDL_GetPerformanceCounter()};
+
+    // Get the time of this iteration.
+    Uint64 const currentTime{SDL_GetTicks64()};
+
+    // Record the input as it comes from the event queue, so that replaying it does not record it again.
+    InputTrace::recordFrame(currentTime);
+    bool const isRendered{updateInput(currentTime, [](SDL_Event &event) -> bool {
+        if (SDL_PollEvent(&event) == 0) return false;
+        InputTrace::recordEvent(event);
+        return true;
+    })};
+    if (not isRendered) return;
+
     refreshWindow();
 
-    // As this iteration ends, update the previous time.
-    previousTime = currentTime;
+    setBusyFrameTime(static_cast<double>(SDL_GetPerformanceCounter() - busyStartCount) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency()));
 
-    // Give the CPU a break?
-    SDL_Delay(1u);
+    #ifndef __EMSCRIPTEN__
+    // Sleep until the next frame is due. (The browser paces the loop itself.)
+    StageTimer::Scope const waitTimer(StageTimer::Stage::wait);
+    FrameScheduler::waitForNextFrame();
+    #endif
 }
 
 namespace Project::SdlContext {
@@ -223,8 +337,8 @@ namespace Project::SdlContext {
     static constexpr SDL_FPoint parametricWithPeriodOfTwoPi(float const percentage) {
         float const t{linearInterpolation<float>(percentage, 0.0f, 2.0f * pi)};
         return {
-            /* x */ canvasBufferWidth  * (xFunction(t) / 2.0f + 0.5f),
-            /* y */ canvasBufferHeight * (yFunction(t) / 2.0f + 0.5f) 
+            /* x */ xFunction(t) / 2.0f + 0.5f,
+            /* y */ yFunction(t) / 2.0f + 0.5f
         };
     }
 
@@ -299,50 +413,26 @@ namespace Project::SdlContext {
 
         SDL_SetWindowTitle(window, buffer);
     }
-}
-
-/** 
- * @note Not thread-safe.
- */
-void Project::SdlContext::refreshWindow() {
-    static HslaColor mainColor;
 
+    // Position in the animation of the main color's hue.
     static double huePercentage{0.0};
-    huePercentage = wrapValue(huePercentage + static_cast<double>(deltaTime) * (0.0008), 1.0);
 
+    // Position in the animation of the source points.
     static double sourceFunctionPercentage{0.0};
-    sourceFunctionPercentage = wrapValue(sourceFunctionPercentage + static_cast<double>(deltaTime) * (0.000025), 1.0);
-
-    mainColor.setHue(linearInterpolation(huePercentage, 0.0, 360.0));
-
-    static constexpr int const minLength{std::min(canvasBufferWidth, canvasBufferHeight)};
-    static constexpr double const hueUnit{2.0 * 360.0 / static_cast<double>(minLength)};
-
-    void *pixelPointer;
-    int pitch;
-    check(SDL_LockTexture(canvasBuffer, nullptr/* lock entire texture */, &pixelPointer, &pitch));
-
-    #pragma GCC diagnostic push
-    #pragma GCC diagnostic ignored "-Wnarrowing"
-    int const bytesPerPixel{SDL_BYTESPERPIXEL(pixelFormat->format)};
-    #pragma GCC diagnostic pop
-    int const pixelRowLength{pitch / bytesPerPixel};
-
-    Uint32 *const pixelArray = static_cast<Uint32 *>(pixelPointer);
 
     static constexpr auto outlineCanvas = [](float const percentage) constexpr -> SDL_FPoint {
         /****/ if (percentage <= .25) {
-            return {linearInterpolation<float>(percentage * 4.0, 0.0f, canvasBufferWidth), 0.0};
+            return {linearInterpolation<float>(percentage * 4.0, 0.0f, 1.0f), 0.0};
         } else if (percentage <= .50) {
-            return {canvasBufferWidth, linearInterpolation<float>((percentage - .25) * 4.0, 0.0f, canvasBufferHeight)};
+            return {1.0f, linearInterpolation<float>((percentage - .25) * 4.0, 0.0f, 1.0f)};
         } else if (percentage <= .75) {
-            return {linearInterpolation<float>((percentage - .50) * 4.0, canvasBufferWidth, 0.0f), canvasBufferHeight};
+            return {linearInterpolation<float>((percentage - .50) * 4.0, 1.0f, 0.0f), 1.0f};
         } else {
-            return {0.0, linearInterpolation<float>((percentage - .75) * 4.0, canvasBufferHeight, 0.0f)};
+            return {0.0, linearInterpolation<float>((percentage - .75) * 4.0, 1.0f, 0.0f)};
         }
     };
 
-    // Parametric functions.
+    // Parametric functions. Points are given as a fraction of the canvas buffer's size.
     static constexpr std::array sourceFunctionList{
 
         parametricWithPeriodOfTwoPi</* x */ sine<3>, /* y */ sine<2>>,
@@ -360,65 +450,432 @@ void Project::SdlContext::refreshWindow() {
 
     };
 
-    static std::array<SDL_FPoint, sourceFunctionList.size()> sourcePointList{};
-    std::transform(
-        sourceFunctionList.begin(), sourceFunctionList.end(),
-        sourcePointList.begin(),
-        [](decltype(sourceFunctionList)::value_type const sourceFunction) constexpr -> SDL_FPoint {
-            return sourceFunction(sourceFunctionPercentage);
-        }
-    );
+    // Threads that render bands of rows of the canvas. Created on first use.
+    static std::unique_ptr<WorkerPool> workerPool;
 
-    for (int y{0}; y < canvasBufferHeight; ++y) {
-        for (int x{0}; x < canvasBufferWidth; ++x) {
-            HslaColor hslaPixel(mainColor);
-
-            enum struct PointType : std::uint_least8_t { sink, source, };
-            auto const processPoint = [x, y, &hslaPixel](
-                SDL_FPoint const &point,
-                PointType const pointType
-            ) -> void {
-                double const distance{
-                    std::sqrt(std::pow(static_cast<double>(x) - point.x, 2.0) + std::pow(static_cast<double>(y) - point.y, 2.0))
-                };
+    // Whether the pixels are computed on the render thread while the main thread presents.
+    static bool pipelineIsEnabled{false};
+
+    // Created on the first frame after the pipeline is enabled. (Declared after the worker pool that it uses.)
+    static std::unique_ptr<RenderThread> renderThread;
 
-                double const hueOffset{(hueUnit + hueSummand) * distance};
-
-                switch (pointType) {
-                    case PointType::source:
-                        hslaPixel.setHue(hslaPixel.getHue() - hueOffset);
-                        break;
-                    case PointType::sink:
-                        hslaPixel.setHue(hslaPixel.getHue() + hueOffset);
-                        break;
-                    default:
-                        throw pointType;
-                }
+    static CanvasRenderer canvasRenderer(defaultCanvasBufferWidth, defaultCanvasBufferHeight);
+
+    // State of the frame that is being rendered.
+    static FrameState frameState;
+
+    // Farthest distance in pixels that a point may move before the spatial hue field is recomputed, in frames of `renderCanvas`.
+    static float fieldReuseDistance{defaultFieldReuseDistance};
+
+    // Largest error in degrees of hue of an interpolated spatial hue field, or zero to compute every pixel.
+    static float fieldTolerance{0.0f};
+
+    // Whether `renderCanvas` renders every frame again with the reference kernel backend and compares the pixels.
+    static bool kernelVerificationIsEnabled{false};
+
+    // Renders the frames of the verification with the reference kernel backend. Created on the first verified frame.
+    static std::unique_ptr<CanvasRenderer> referenceRenderer;
+    static std::vector<Uint8> referencePixelList;
+
+    static long long verifiedFrameCount{0};
+    static int largestKernelDifference{-1};
+
+    static void verifyCanvas(void const *const pixelPointer, int const pitch);
+
+    /**
+     * @brief Fill a frame state from positions in the animation and the interaction state.
+     * 
+     * @param sinkList sinks as fractions of the canvas buffer's size
+     * @param sinkCount number of sinks
+     * @param reuseDistance farthest distance in pixels that a point may move before the spatial hue field is recomputed
+     * @param stride side in pixels of the blocks that share one computed hue
+     */
+    static void fillFrameState(
+        FrameState &state,
+        double const huePercentageValue,
+        double const sourceFunctionPercentageValue,
+        float const hueSummandValue,
+        SDL_FPoint const *const sinkList,
+        int const sinkCount,
+        int const width,
+        int const height,
+        float const reuseDistance,
+        int const stride
+    ) {
+        static constexpr int const defaultMinLength{std::min(defaultCanvasBufferWidth, defaultCanvasBufferHeight)};
+        static constexpr float const hueUnit{2.0f * 360.0f / static_cast<float>(defaultMinLength)};
+
+        // The saturation, luminance, and alpha of the main color never change.
+        state.color = HslaColor();
+        state.color.setHue(linearInterpolation(huePercentageValue, 0.0, 360.0));
+
+        // Distances are measured in pixels of the canvas buffer, so scale the hue to draw the same picture at any size.
+        float const pixelScale{static_cast<float>(defaultMinLength) / static_cast<float>(std::min(width, height))};
+        state.hueScale = (hueUnit + hueSummandValue) * pixelScale;
+
+        auto const toCanvasBuffer = [width, height](SDL_FPoint const &point) -> SDL_FPoint {
+            return {
+                linearInterpolation<float>(point.x, 0.0f, static_cast<float>(width)),
+                linearInterpolation<float>(point.y, 0.0f, static_cast<float>(height))
             };
+        };
 
-            if (mouse.has_value() and fingerMap.size() == 0u) processPoint(*mouse, PointType::sink);
+        state.fieldReuseDistance = reuseDistance;
+        state.fieldStride = stride;
+        state.fieldTolerance = fieldTolerance;
 
-            for (auto const &[identifier, point] : fingerMap) processPoint(
-                point,
-                PointType::sink
-            );
+        state.pointList.clear();
+        for (int index{0}; index < sinkCount; ++index) state.pointList.add(toCanvasBuffer(sinkList[index]), /* sink */ +1.0f);
+        for (auto const sourceFunction : sourceFunctionList) state.pointList.add(
+            toCanvasBuffer(sourceFunction(static_cast<float>(sourceFunctionPercentageValue))), /* source */ -1.0f
+        );
+    }
+}
 
-            for (auto const &point : sourcePointList) processPoint(point, PointType::source);
+void Project::SdlContext::setThreadCount(int const threadCount) {
+    workerPool = std::make_unique<WorkerPool>(threadCount);
+}
 
-            SDL_Color const rgbaPixel(hslaPixel.toRgbaColor());
+int Project::SdlContext::getThreadCount() { return getWorkerPool().getThreadCount(); }
 
-            pixelArray[y/* row */ * pixelRowLength + x/* column */] = SDL_MapRGBA(
-                pixelFormat, rgbaPixel.r, rgbaPixel.g, rgbaPixel.b, rgbaPixel.a
-            );
+void Project::SdlContext::setPipelineEnabled(bool const isEnabled) {
+    pipelineIsEnabled = isEnabled;
+    if (not isEnabled) {
+        renderThread.reset();
+        pipelineRenderTime = 0.0;
+    }
+}
+
+bool Project::SdlContext::isPipelineEnabled() { return pipelineIsEnabled; }
+
+Project::WorkerPool &Project::SdlContext::getWorkerPool() {
+    if (workerPool == nullptr) workerPool = std::make_unique<WorkerPool>(WorkerPool::getDefaultThreadCount());
+    return *workerPool;
+}
+
+void Project::SdlContext::resizeCanvasBuffer(int const width, int const height) {
+    requestedCanvasBufferWidth = std::max(1, width);
+    requestedCanvasBufferHeight = std::max(1, height);
+    canvasBufferScale = 1.0;
+    applyCanvasBufferSize(requestedCanvasBufferWidth, requestedCanvasBufferHeight);
+}
+
+void Project::SdlContext::setTargetFrameTime(Uint64 const time) { targetFrameTime = time; }
+
+/**
+ * @brief Resize the hue field, and recreate the canvas texture if there is a renderer.
+ * 
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::applyCanvasBufferSize(int const width, int const height) {
+    canvasBufferWidth = width;
+    canvasBufferHeight = height;
+    canvasRenderer.resize(width, height);
+
+    if (renderer == nullptr or pixelFormat == nullptr) return;
+
+    if (canvasBuffer != nullptr) SDL_DestroyTexture(canvasBuffer);
+    canvasBuffer = check(SDL_CreateTexture(
+        renderer,
+        pixelFormat->format, SDL_TEXTUREACCESS_STREAMING,
+        canvasBufferWidth, canvasBufferHeight
+    ));
+    check(SDL_SetTextureBlendMode(canvasBuffer, SDL_BLENDMODE_NONE));
+}
+
+/**
+ * @brief Grow or shrink the canvas buffer so that the average busy time of a frame approaches the target frame time.
+ * 
+ * @note The busy time leaves out the wait for the next frame, so a frame rate limit does not make rendering look slow.
+ * The delta time still spaces the resizes, and a delta time of a stall skips the frame.
+ * 
+ * @note The size changes by a few percent at a time, at most twice a second,
+ * and stays between 32 pixels on the short side and the size of the window.
+ * 
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::adaptCanvasBufferSize() {
+    static double averageFrameTime{0.0};
+    static Uint64 timeSinceResize{0u};
+
+    if (targetFrameTime == 0u) return;
+
+    // Ignore stalls, such as the first frame or a dragged window.
+    if (deltaTime > 250u) return;
+
+    double const target{static_cast<double>(targetFrameTime)};
+    if (averageFrameTime == 0.0) averageFrameTime = target;
+    averageFrameTime = linearInterpolation(0.1, averageFrameTime, busyFrameTime);
+
+    if ((timeSinceResize += deltaTime) < 500u) return;
+
+    double scale{canvasBufferScale};
+    /**/ if (averageFrameTime > target * 1.2) scale *= 0.85;
+    else if (averageFrameTime < target * 0.75) scale *= 1.1;
+    else return;
+
+    double const minimumScale{32.0 / static_cast<double>(std::min(requestedCanvasBufferWidth, requestedCanvasBufferHeight))};
+    double const maximumScale{std::max({
+        1.0,
+        static_cast<double>(windowWidth) / static_cast<double>(requestedCanvasBufferWidth),
+        static_cast<double>(windowHeight) / static_cast<double>(requestedCanvasBufferHeight)
+    })};
+    scale = std::clamp(scale, std::min(minimumScale, 1.0), maximumScale);
+
+    int const width{std::max(1, static_cast<int>(std::lround(requestedCanvasBufferWidth * scale)))};
+    int const height{std::max(1, static_cast<int>(std::lround(requestedCanvasBufferHeight * scale)))};
+    if (width == canvasBufferWidth and height == canvasBufferHeight) return;
+
+    canvasBufferScale = scale;
+    applyCanvasBufferSize(width, height);
+    timeSinceResize = 0u;
+    averageFrameTime = target;
+}
+
+void Project::SdlContext::setDeltaTime(Uint64 const time) { deltaTime = time; }
+
+void Project::SdlContext::setBusyFrameTime(double const time) { busyFrameTime = std::max(pipelineRenderTime, time); }
+
+/**
+ * @brief Pause or resume the animation and the rendering, and log how much processor time a pause used against rendering.
+ * 
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::setRenderingPaused(bool const isPaused) {
+    if (isPaused == renderingIsPaused) return;
+    renderingIsPaused = isPaused;
+
+    Uint64 const now{SDL_GetTicks64()};
+    std::clock_t const clock{std::clock()};
+    Uint64 const elapsedTime{now - pauseChangeTime};
+    std::clock_t const elapsedClock{clock - pauseChangeClock};
+    pauseChangeTime = now;
+    pauseChangeClock = clock;
+
+    if (isPaused) {
+        renderingTime += elapsedTime;
+        renderingClock += elapsedClock;
+        return;
+    }
+
+    // The frame that resumes does not advance the animation, and its deadline starts from now.
+    deltaTime = 0u;
+    FrameScheduler::restart();
+
+    auto const toPercentage = [](std::clock_t const clockValue, Uint64 const time) -> double {
+        return time == 0u ? 0.0 : 100.0 * static_cast<double>(clockValue) / CLOCKS_PER_SEC / (static_cast<double>(time) / 1000.0);
+    };
+    SDL_LogInfo(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Paused rendering for %g seconds while the window was hidden, using %.2f%% of a processor, against %.1f%% while rendering.",
+        static_cast<double>(elapsedTime) / 1000.0, toPercentage(elapsedClock, elapsedTime), toPercentage(renderingClock, renderingTime)
+    );
+}
+
+void Project::SdlContext::setProgressiveEnabled(bool const isEnabled) { progressiveIsEnabled = isEnabled; }
+
+/**
+ * @brief Coarsen the hue field while the user interacts, and refine it one step per frame after.
+ * 
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::updateFieldStride(bool const isInteracting) {
+    static constexpr int defaultArea{defaultCanvasBufferWidth * defaultCanvasBufferHeight};
+
+    /**/ if (not progressiveIsEnabled)
+        fieldStride = 1;
+    else if (isInteracting)
+        fieldStride = canvasBufferWidth * canvasBufferHeight > 4 * defaultArea ? 4 : 2;
+    else
+        fieldStride = std::max(1, fieldStride / 2);
+}
+
+/**
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::updateAnimation() {
+    huePercentage = wrapValue(huePercentage + static_cast<double>(deltaTime) * (0.0008), 1.0);
+
+    sourceFunctionPercentage = wrapValue(sourceFunctionPercentage + static_cast<double>(deltaTime) * (0.000025), 1.0);
+}
+
+void Project::SdlContext::setFieldReuseDistance(float const distance) { fieldReuseDistance = std::max(0.0f, distance); }
+
+void Project::SdlContext::setFieldTolerance(float const tolerance) { fieldTolerance = std::max(0.0f, tolerance); }
+
+long long Project::SdlContext::getFieldUpdateCount() { return canvasRenderer.getFieldUpdateCount(); }
+
+void Project::SdlContext::captureFrameState(FrameState &state) {
+    // Take a snapshot of the sinks: the fingers, or else the mouse.
+    std::array<SDL_FPoint, TouchPointSet::capacity> sinkList;
+    int sinkCount{0};
+    for (; sinkCount < touchPointSet.size(); ++sinkCount) sinkList[static_cast<std::size_t>(sinkCount)] = touchPointSet.getPoint(sinkCount);
+    if (mouse.has_value() and touchPointSet.empty()) sinkList[static_cast<std::size_t>(sinkCount++)] = *mouse;
+
+    fillFrameState(
+        state, huePercentage, sourceFunctionPercentage, hueSummand, sinkList.data(), sinkCount, canvasBufferWidth, canvasBufferHeight, fieldReuseDistance, fieldStride
+    );
+}
+
+void Project::SdlContext::computeAnimationFrameState(FrameState &state, double const time, int const width, int const height) {
+    fillFrameState(
+        state,
+        wrapValue(time * (0.0008), 1.0),
+        wrapValue(time * (0.000025), 1.0),
+        0.0f,
+        nullptr, 0,
+        width,
+        height,
+        // Reuse only an identical field, so that every frame is the same whichever renderer rendered the frame before.
+        0.0f,
+        1
+    );
+}
+
+/**
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::renderCanvas(void *const pixelPointer, int const pitch) {
+    captureFrameState(frameState);
+    canvasRenderer.render(frameState, *pixelFormat, pixelPointer, pitch, &getWorkerPool());
+    if (kernelVerificationIsEnabled) verifyCanvas(pixelPointer, pitch);
+}
+
+void Project::SdlContext::setKernelVerificationEnabled(bool const isEnabled) { kernelVerificationIsEnabled = isEnabled; }
+
+bool Project::SdlContext::isKernelVerificationEnabled() { return kernelVerificationIsEnabled; }
+
+int Project::SdlContext::getLargestKernelDifference() { return largestKernelDifference; }
+
+/**
+ * @brief Render the frame state again with the reference kernel backend, compare every channel of every pixel,
+ * and log the largest difference whenever it grows.
+ * 
+ * @note The reference renderer sees the same frame states as the canvas renderer, so it reuses its hue field in the same frames.
+ * 
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::verifyCanvas(void const *const pixelPointer, int const pitch) {
+    int const width{canvasRenderer.getWidth()}, height{canvasRenderer.getHeight()};
+    if (referenceRenderer == nullptr) {
+        referenceRenderer = std::make_unique<CanvasRenderer>(width, height, &KernelBackend::getReference());
+    } else if (referenceRenderer->getWidth() != width or referenceRenderer->getHeight() != height) {
+        referenceRenderer->resize(width, height);
+    }
+
+    referencePixelList.resize(static_cast<std::size_t>(pitch) * static_cast<std::size_t>(height));
+    referenceRenderer->render(frameState, *pixelFormat, referencePixelList.data(), pitch, &getWorkerPool());
+
+    int const bytesPerPixel{pixelFormat->BytesPerPixel};
+    auto const readPixel = [bytesPerPixel](Uint8 const *const address) -> Uint32 {
+        if (bytesPerPixel == 2) {
+            Uint16 pixel;
+            std::memcpy(&pixel, address, sizeof(pixel));
+            return pixel;
+        }
+        Uint32 pixel;
+        std::memcpy(&pixel, address, sizeof(pixel));
+        return pixel;
+    };
+
+    Uint8 const *const pixelBytes{static_cast<Uint8 const *>(pixelPointer)};
+    int frameDifference{0};
+    for (int y{0}; y < height; ++y) for (int x{0}; x < width; ++x) {
+        std::ptrdiff_t const offset{static_cast<std::ptrdiff_t>(y) * pitch + static_cast<std::ptrdiff_t>(x) * bytesPerPixel};
+        std::array<Uint8, 4u> channelList, referenceChannelList;
+        SDL_GetRGBA(readPixel(pixelBytes + offset), pixelFormat, &channelList[0], &channelList[1], &channelList[2], &channelList[3]);
+        SDL_GetRGBA(
+            readPixel(referencePixelList.data() + offset), pixelFormat,
+            &referenceChannelList[0], &referenceChannelList[1], &referenceChannelList[2], &referenceChannelList[3]
+        );
+        for (std::size_t channel{0u}; channel < channelList.size(); ++channel) {
+            frameDifference = std::max(frameDifference, std::abs(channelList[channel] - referenceChannelList[channel]));
         }
     }
 
-    SDL_UnlockTexture(canvasBuffer);
+    if (++verifiedFrameCount == 1) SDL_LogInfo(
+        SDL_LOG_CATEGORY_APPLICATION, "Verifying the %s kernel backend against the %s reference.",
+        KernelBackend::getSelected().name, KernelBackend::getReference().name
+    );
 
-    // Copy pixel data from the canvas buffer to the window.
-    check(SDL_RenderCopy(renderer, canvasBuffer, nullptr/* use entire texture */, nullptr/* stretch texture to entire window */));
+    if (frameDifference <= largestKernelDifference) return;
+    largestKernelDifference = frameDifference;
+    if (frameDifference > 0) SDL_LogInfo(
+        SDL_LOG_CATEGORY_APPLICATION, "The %s kernel backend differs from the %s reference by up to %d in a channel, first in frame %lld.",
+        KernelBackend::getSelected().name, KernelBackend::getReference().name, largestKernelDifference, verifiedFrameCount
+    );
+}
 
-    refreshTitle(huePercentage);
+bool Project::SdlContext::replayInput(Uint64 const time, SDL_Event const *const eventList, std::size_t const eventCount) {
+    std::size_t index{0u};
+    return updateInput(time, [eventList, eventCount, &index](SDL_Event &event) -> bool {
+        if (index == eventCount) return false;
+        event = eventList[index++];
+        return true;
+    });
+}
 
-    SDL_RenderPresent(renderer);
+/** 
+ * @note Not thread-safe.
+ */
+void Project::SdlContext::refreshWindow() {
+    using StageTimer::Stage;
+
+    {
+        StageTimer::Scope const timer(Stage::animation);
+        updateAnimation();
+    }
+
+    if (pipelineIsEnabled) {
+        RenderThread::Frame const *frame;
+
+        {
+            StageTimer::Scope const timer(Stage::pixels);
+
+            if (renderThread == nullptr) renderThread = std::make_unique<RenderThread>(*pixelFormat, &getWorkerPool());
+
+            // Hand this frame's state to the render thread, and take the latest frame that it finished.
+            captureFrameState(frameState);
+            renderThread->submit(frameState, canvasBufferWidth, canvasBufferHeight);
+            frame = renderThread->takeFrame();
+        }
+
+        StageTimer::Scope const timer(Stage::upload);
+
+        // If no new frame is finished, or it is of a previous size, the canvas buffer keeps the last frame.
+        if (frame != nullptr and frame->width == canvasBufferWidth and frame->height == canvasBufferHeight) {
+            check(SDL_UpdateTexture(canvasBuffer, nullptr/* update entire texture */, frame->pixelList.data(), frame->pitch));
+            pipelineRenderTime = frame->renderTime;
+        }
+
+        // Copy pixel data from the canvas buffer to the window.
+        check(SDL_RenderCopy(renderer, canvasBuffer, nullptr/* use entire texture */, nullptr/* stretch texture to entire window */));
+    } else {
+        {
+            StageTimer::Scope const timer(Stage::pixels);
+
+            void *pixelPointer;
+            int pitch;
+            check(SDL_LockTexture(canvasBuffer, nullptr/* lock entire texture */, &pixelPointer, &pitch));
+
+            renderCanvas(pixelPointer, pitch);
+        }
+
+        StageTimer::Scope const timer(Stage::upload);
+
+        SDL_UnlockTexture(canvasBuffer);
+
+        // Copy pixel data from the canvas buffer to the window.
+        check(SDL_RenderCopy(renderer, canvasBuffer, nullptr/* use entire texture */, nullptr/* stretch texture to entire window */));
+    }
+
+    {
+        StageTimer::Scope const timer(Stage::title);
+        refreshTitle(huePercentage);
+    }
+
+    {
+        StageTimer::Scope const timer(Stage::present);
+        SDL_RenderPresent(renderer);
+    }
 }
@@ -11,6 +11,11 @@
 
 #include <sstream>
 
+namespace Project {
+    struct FrameState;
+    class WorkerPool;
+}
+
 namespace Project::SdlContext {
     [[noreturn]]
     inline void errorOut() {
@@ -51,14 +56,170 @@ namespace Project::SdlContext {
     extern void refreshCachedWindowSize();
 
     extern Uint64 getDeltaTime();
+    extern void setDeltaTime(Uint64 const time);
+
+    /**
+     * @brief Set how long the last frame took to handle its events and render, without waiting for the next frame.
+     * 
+     * @note The main loop measures this itself; loops that render frames otherwise, such as replays, set it for adaptive resolution.
+     * With the pipeline, the render time of the latest frame counts instead when it is longer.
+     * 
+     * @param time busy time of the calling thread in milliseconds
+     */
+    extern void setBusyFrameTime(double const time);
     extern int getWindowWidth();
     extern int getWindowHeight();
 
-    inline constexpr int canvasBufferWidth{270}, canvasBufferHeight{270};
+    /*
+        Size of the canvas buffer unless another size is asked for.
+        The picture is drawn to the same scale at any size, relative to this size.
+    */
+    inline constexpr int defaultCanvasBufferWidth{270}, defaultCanvasBufferHeight{270};
+
+    extern int getCanvasBufferWidth();
+    extern int getCanvasBufferHeight();
+
+    /**
+     * @brief Set the size of the canvas buffer, and recreate the canvas texture if there is a renderer.
+     * 
+     * @note With adaptive resolution, this is the size that the adaptation starts from.
+     */
+    extern void resizeCanvasBuffer(int const width, int const height);
+
+    /**
+     * @brief Turn on adaptive resolution, which grows or shrinks the canvas buffer to hold the busy time of a frame near a target.
+     * 
+     * @note The busy time runs from handling the events through presenting, without the wait for the next frame.
+     * 
+     * @param time target frame time in milliseconds, or zero to turn adaptive resolution off
+     */
+    extern void setTargetFrameTime(Uint64 const time);
 
     extern void exitHandler();
     extern void mainLoop();
     extern void refreshWindow();
+
+    /**
+     * @brief Run an iteration of the main loop up to rendering, at a given time and with given events
+     * instead of the clock and the event queue, so that a recorded input trace renders the same frames.
+     * 
+     * @note The caller renders the frame, with `refreshWindow`, or with `updateAnimation` and `renderCanvas`. Not thread-safe.
+     * 
+     * @param time time of the iteration in milliseconds, on the clock of `SDL_GetTicks64`
+     * @param eventList events to handle, in order
+     * @param eventCount number of events
+     * @return whether the iteration renders a frame, which it does not while the window is hidden
+     */
+    extern bool replayInput(Uint64 const time, SDL_Event const *const eventList, std::size_t const eventCount);
+
+    /**
+     * @brief Advance the positions in the animation of the base hue and the source points by the delta time.
+     * 
+     * @note The hue and the points themselves are computed from these positions when the frame state is captured.
+     */
+    extern void updateAnimation();
+
+    /**
+     * @brief Compute every pixel of the canvas into a pixel buffer laid out in `pixelFormat`.
+     * 
+     * @note This function does not touch the window, the renderer, nor the canvas texture,
+     * so it can render into plain CPU memory.
+     * 
+     * @param pixelPointer first pixel of the buffer
+     * @param pitch length of a row of the buffer in bytes
+     */
+    extern void renderCanvas(void *const pixelPointer, int const pitch);
+
+    /**
+     * @brief Render every frame of `renderCanvas` again with the reference kernel backend, and compare the pixels.
+     * 
+     * @note The largest difference of a channel, in steps of 8 bits, is logged whenever it grows.
+     * Frames computed by the render thread of the pipeline are not verified; `main` warns when both are asked for.
+     */
+    extern void setKernelVerificationEnabled(bool const isEnabled);
+    extern bool isKernelVerificationEnabled();
+
+    /**
+     * @return largest difference of a channel between the selected kernel backend and the reference so far, or -1 before the first verified frame
+     */
+    extern int getLargestKernelDifference();
+
+    // Farthest distance in pixels that a point may move before the spatial hue field is recomputed, unless another is asked for; zero keeps frames exact.
+    inline constexpr float defaultFieldReuseDistance{0.0f};
+
+    /**
+     * @brief Set how far a point may move, in pixels of the canvas buffer, before the spatial hue field is recomputed.
+     * 
+     * @note Frames in between only rotate the hue of the reused field. On the default canvas, a point that moves
+     * by a pixel changes a hue by at most about 2.7 degrees. The distance applies to every frame of `renderCanvas`,
+     * including benchmarks and replays; frames of an animation export always reuse only an identical field.
+     * 
+     * @param distance distance in pixels, or zero to recompute the field whenever a point moved at all
+     */
+    extern void setFieldReuseDistance(float const distance);
+
+    /**
+     * @brief Interpolate the spatial hue field inside the cells of a coarse grid when there are many points.
+     * 
+     * @note Cells near points, and cells where interpolating is off by more than the tolerance, are split down to a few pixels.
+     * The field is only interpolated with at least `HueField::minInterpolatedPointCount` points; with fewer, every pixel is computed.
+     * 
+     * @param tolerance largest error in degrees of hue, or zero to compute every pixel
+     */
+    extern void setFieldTolerance(float const tolerance);
+
+    /**
+     * @brief Render coarse previews while the user interacts, and refine them once the input settles.
+     * 
+     * @note While a mouse button is held or a finger touches the window, the spatial hue field is computed
+     * once per block of 2 by 2 pixels, or 4 by 4 on canvas buffers of more than four times the default area.
+     * Once the interaction ends, the blocks halve in every frame until every pixel is computed again.
+     */
+    extern void setProgressiveEnabled(bool const isEnabled);
+
+    /**
+     * @return number of frames rendered by `renderCanvas` whose spatial hue field was recomputed instead of reused
+     */
+    extern long long getFieldUpdateCount();
+
+    /**
+     * @brief Fill a frame state from the current animation and interaction state.
+     * 
+     * @note Not thread-safe.
+     */
+    extern void captureFrameState(FrameState &state);
+
+    /**
+     * @brief Fill a frame state as a pure function of animation time, without any interaction.
+     * 
+     * @note Thread-safe.
+     * 
+     * @param time animation time in milliseconds
+     * @param width width of the canvas buffer to render the frame at
+     * @param height height of the canvas buffer to render the frame at
+     */
+    extern void computeAnimationFrameState(FrameState &state, double const time, int const width, int const height);
+
+    /**
+     * @brief Set the number of threads that `renderCanvas` uses, including the calling thread.
+     * 
+     * @note By default, every processor of the machine is used.
+     */
+    extern void setThreadCount(int const threadCount);
+    extern int getThreadCount();
+
+    /**
+     * @brief Compute the pixels on a render thread, so that the next frame is computed while this frame is presented.
+     * 
+     * @note The render thread needs threads; builds for the web without pthreads cannot use it.
+     */
+    extern void setPipelineEnabled(bool const isEnabled);
+    extern bool isPipelineEnabled();
+
+    /**
+     * @brief Get the threads that render the canvas. Created with every processor on first use.
+     */
+    extern WorkerPool &getWorkerPool();
 }
 
 
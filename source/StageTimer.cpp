@@ -0,0 +1,114 @@
+#include "StageTimer.hpp"
+
+#ifdef PROJECT_STAGE_TIMING
+
+#include <array>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include "project_utility.hpp"
+#include "project_print.hpp"
+
+namespace Project::StageTimer {
+    /*
+        Each power of two of nanoseconds is split into four buckets,
+        so a bucket is at most about 19% wider than the one before it.
+    */
+    static constexpr int subBucketBits{2};
+    static constexpr int bucketCount{64 << subBucketBits};
+
+    struct Histogram {
+        std::array<Uint64, bucketCount> bucketList{};
+        Uint64 count{0u}, total{0u}, minimum{std::numeric_limits<Uint64>::max()}, maximum{0u};
+    };
+
+    static std::array<Histogram, static_cast<std::size_t>(Stage::count)> histogramList;
+
+    static constexpr std::array<char const *, static_cast<std::size_t>(Stage::count)> stageNameList{
+        "events", "animation", "pixels", "upload", "title", "present", "wait", "frame",
+    };
+
+    static std::string outputPath;
+
+    static int bucketOf(Uint64 const nanoseconds) {
+        if (nanoseconds < (1u << subBucketBits)) return static_cast<int>(nanoseconds);
+        int const exponent{63 - __builtin_clzll(nanoseconds)};
+        int const subBucket{static_cast<int>((nanoseconds >> (exponent - subBucketBits)) & ((1u << subBucketBits) - 1u))};
+        return ((exponent - subBucketBits + 1) << subBucketBits) + subBucket;
+    }
+
+    // Smallest duration that falls in the bucket after this one.
+    static Uint64 bucketUpperBound(int const bucket) {
+        int const nextBucket{bucket + 1};
+        if (nextBucket < (1 << subBucketBits)) return static_cast<Uint64>(nextBucket);
+        int const exponent{(nextBucket >> subBucketBits) + subBucketBits - 1};
+        Uint64 const subBucket{static_cast<Uint64>(nextBucket & ((1 << subBucketBits) - 1))};
+        if (exponent >= 64) return std::numeric_limits<Uint64>::max();
+        return (Uint64{1u} << exponent) + (subBucket << (exponent - subBucketBits));
+    }
+
+    static Uint64 percentile(Histogram const &histogram, double const percentage) {
+        auto const rank{static_cast<Uint64>(percentage * static_cast<double>(histogram.count))};
+        Uint64 seen{0u};
+        for (int bucket{0}; bucket < bucketCount; ++bucket) {
+            seen += histogram.bucketList[static_cast<std::size_t>(bucket)];
+            if (seen > rank) return std::min(bucketUpperBound(bucket), histogram.maximum);
+        }
+        return histogram.maximum;
+    }
+}
+
+void Project::StageTimer::record(Stage const stage, Uint64 const nanoseconds) {
+    auto &histogram = histogramList[static_cast<std::size_t>(stage)];
+    ++histogram.bucketList[static_cast<std::size_t>(bucketOf(nanoseconds))];
+    ++histogram.count;
+    histogram.total += nanoseconds;
+    histogram.minimum = std::min(histogram.minimum, nanoseconds);
+    histogram.maximum = std::max(histogram.maximum, nanoseconds);
+}
+
+std::string Project::StageTimer::toJson() {
+    std::ostringstream stream;
+    stream << "{\"unit\":\"ns\",\"stages\":{";
+    for (std::size_t stageIndex{0u}; stageIndex < histogramList.size(); ++stageIndex) {
+        auto const &histogram = histogramList[stageIndex];
+        if (stageIndex > 0u) stream << ',';
+        stream << '"' << stageNameList[stageIndex] << "\":{\"count\":" << histogram.count;
+        if (histogram.count > 0u) stream
+            << ",\"total\":" << histogram.total
+            << ",\"min\":" << histogram.minimum
+            << ",\"mean\":" << histogram.total / histogram.count
+            << ",\"p50\":" << percentile(histogram, 0.50)
+            << ",\"p90\":" << percentile(histogram, 0.90)
+            << ",\"p99\":" << percentile(histogram, 0.99)
+            << ",\"max\":" << histogram.maximum;
+
+        // Only the buckets that are not empty, as pairs of [upper bound, count].
+        stream << ",\"histogram\":[";
+        bool isFirst{true};
+        for (int bucket{0}; bucket < bucketCount; ++bucket) {
+            Uint64 const count{histogram.bucketList[static_cast<std::size_t>(bucket)]};
+            if (count == 0u) continue;
+            if (not isFirst) stream << ',';
+            isFirst = false;
+            stream << '[' << bucketUpperBound(bucket) << ',' << count << ']';
+        }
+        stream << "]}";
+    }
+    stream << "}}";
+    return stream.str();
+}
+
+void Project::StageTimer::setOutputPath(std::string const &path) { outputPath = path; }
+
+void Project::StageTimer::dump(bool const onlyToFile) {
+    if (outputPath.empty()) {
+        if (not onlyToFile) println(toJson());
+        return;
+    }
+
+    std::ofstream file(outputPath);
+    if (not (file << toJson() << '\n')) SdlContext::warn("Failed to write the stage timings to \"", outputPath, "\".");
+}
+
+#endif
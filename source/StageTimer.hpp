@@ -0,0 +1,85 @@
+#ifndef StageTimer_hpp
+#define StageTimer_hpp true
+
+#include <cstdint>
+#include <string>
+#include "SdlContext.hpp"
+
+/*
+    High-resolution timers around each stage of a frame, aggregated into per-stage histograms.
+
+    The timers are compiled in only when `PROJECT_STAGE_TIMING` is defined.
+    Otherwise, every function here is an empty inline function, so the timers cost nothing.
+*/
+namespace Project::StageTimer {
+    enum struct Stage : std::uint_least8_t {
+        events,     // polling and handling SDL events
+        animation,  // advancing the animation
+        pixels,     // computing the pixels of the canvas
+        upload,     // unlocking the canvas texture and copying it to the window
+        title,      // refreshing the title of the window
+        present,    // presenting the renderer
+        wait,       // waiting for the next frame
+        frame,      // the whole iteration of the main loop
+        count
+    };
+
+    #ifdef PROJECT_STAGE_TIMING
+    inline constexpr bool isEnabled{true};
+
+    /**
+     * @brief Add a duration to the histogram of a stage.
+     * 
+     * @note Not thread-safe.
+     */
+    extern void record(Stage const stage, Uint64 const nanoseconds);
+
+    /**
+     * @return the histograms of every stage as a JSON object
+     */
+    extern std::string toJson();
+
+    /**
+     * @brief Set the file that `dump` writes to. If empty, `dump` writes to the standard output.
+     */
+    extern void setOutputPath(std::string const &path);
+
+    /**
+     * @brief Write the histograms as JSON to the output path.
+     * 
+     * @param onlyToFile if true, do nothing when there is no output path
+     */
+    extern void dump(bool const onlyToFile=false);
+
+    /**
+     * @brief Time the stage from construction to destruction.
+     */
+    class Scope {
+      public:
+        explicit Scope(Stage const stageValue): stage{stageValue}, startCount{SDL_GetPerformanceCounter()} {}
+        ~Scope() {
+            Uint64 const elapsedCount{SDL_GetPerformanceCounter() - startCount};
+            record(stage, static_cast<Uint64>(static_cast<double>(elapsedCount) * 1.0e9 / static_cast<double>(SDL_GetPerformanceFrequency())));
+        }
+        Scope(Scope const &) = delete;
+        Scope &operator=(Scope const &) = delete;
+      private:
+        Stage stage;
+        Uint64 startCount;
+    };
+    #else
+    inline constexpr bool isEnabled{false};
+
+    inline void record(Stage const, Uint64 const) {}
+    inline std::string toJson() { return "{}"; }
+    inline void setOutputPath(std::string const &) {}
+    inline void dump(bool const = false) {}
+
+    class Scope {
+      public:
+        explicit constexpr Scope(Stage const) {}
+    };
+    #endif
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef TouchPointSet_hpp
+#define TouchPointSet_hpp true
+
+#include <array>
+#include "SdlContext.hpp"
+
+namespace Project {
+  class TouchPointSet;
+}
+
+/**
+ * @brief Fixed-capacity set of active touch points, keyed by finger, stored flat as a structure of arrays.
+ * 
+ * @note Nothing is allocated. Setting a finger's position only overwrites the stored position,
+ * so many motion events in one frame coalesce into the latest position per finger.
+ * Removing a finger moves the last point into its place, so the points stay contiguous.
+ */
+class Project::TouchPointSet {
+  public:
+    static constexpr int capacity{16};
+
+    /**
+     * @brief Set the position of a finger, adding the finger if it is not in the set.
+     * 
+     * @return false if the finger is new and the set is full, in which case the finger is ignored
+     */
+    bool set(SDL_FingerID const finger, float const x, float const y) {
+      int index{find(finger)};
+      if (index == count) {
+        if (count == capacity) return false;
+        fingerList[static_cast<std::size_t>(count++)] = finger;
+      }
+      xList[static_cast<std::size_t>(index)] = x;
+      yList[static_cast<std::size_t>(index)] = y;
+      return true;
+    }
+
+    void erase(SDL_FingerID const finger) {
+      int const index{find(finger)};
+      if (index == count) return;
+      auto const last{static_cast<std::size_t>(--count)};
+      fingerList[static_cast<std::size_t>(index)] = fingerList[last];
+      xList[static_cast<std::size_t>(index)] = xList[last];
+      yList[static_cast<std::size_t>(index)] = yList[last];
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    SDL_FPoint getPoint(int const index) const {
+      return {xList[static_cast<std::size_t>(index)], yList[static_cast<std::size_t>(index)]};
+    }
+
+  private:
+    std::array<SDL_FingerID, capacity> fingerList{};
+    std::array<float, capacity> xList{}, yList{};
+    int count{0};
+
+    // Index of the finger, or `count` if it is not in the set.
+    int find(SDL_FingerID const finger) const {
+      int index{0};
+      while (index < count and fingerList[static_cast<std::size_t>(index)] != finger) ++index;
+      return index;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "Training.hpp"
+#include "SdlContext.hpp"
+#include "project_utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Project::Training {
+    static void pushEvent(SDL_Event &event) {
+        if (SDL_PushEvent(&event) < 0) SdlContext::errorOut();
+    }
+
+    static void pushMouseButton(Uint32 const type, Uint8 const button, int const x, int const y) {
+        SDL_Event event{};
+        event.type = type;
+        event.button.button = button;
+        event.button.x = x;
+        event.button.y = y;
+        pushEvent(event);
+    }
+
+    static void pushMouseMotion(int const x, int const y) {
+        SDL_Event event{};
+        event.type = SDL_MOUSEMOTION;
+        event.motion.x = x;
+        event.motion.y = y;
+        pushEvent(event);
+    }
+
+    /**
+     * @param x position as a fraction of the window's width
+     * @param y position as a fraction of the window's height
+     */
+    static void pushFinger(Uint32 const type, SDL_FingerID const finger, float const x, float const y) {
+        SDL_Event event{};
+        event.type = type;
+        event.tfinger.fingerId = finger;
+        event.tfinger.x = x;
+        event.tfinger.y = y;
+        pushEvent(event);
+    }
+
+    static void pushPinch(float const distance, Uint16 const fingerCount) {
+        SDL_Event event{};
+        event.type = SDL_MULTIGESTURE;
+        event.mgesture.dDist = distance;
+        event.mgesture.numFingers = fingerCount;
+        pushEvent(event);
+    }
+
+    /**
+     * @brief Push the input events of one frame of the script.
+     * 
+     * @note The script has four equal phases: drag with the left mouse button, hold the right mouse button,
+     * touch and pinch with two fingers, and no input.
+     */
+    static void pushInput(int const frame, int const frameCount) {
+        namespace Sdl = SdlContext;
+
+        int const phaseLength{std::max(1, frameCount / 4)};
+        int const phase{frame / phaseLength}, phaseFrame{frame % phaseLength};
+
+        // Position on a circle around the center of the window, one turn per phase.
+        auto const angle{static_cast<float>(2.0 * pi * phaseFrame / phaseLength)};
+        float const x{0.5f + 0.3f * std::cos(angle)}, y{0.5f + 0.3f * std::sin(angle)};
+        int const windowX{static_cast<int>(x * static_cast<float>(Sdl::getWindowWidth()))};
+        int const windowY{static_cast<int>(y * static_cast<float>(Sdl::getWindowHeight()))};
+
+        switch (phase) {
+            case 0:
+                if (phaseFrame == 0) pushMouseButton(SDL_MOUSEBUTTONDOWN, SDL_BUTTON_LEFT, windowX, windowY);
+                else pushMouseMotion(windowX, windowY);
+                if (phaseFrame == phaseLength - 1) pushMouseButton(SDL_MOUSEBUTTONUP, SDL_BUTTON_LEFT, windowX, windowY);
+                break;
+            case 1:
+                if (phaseFrame == 0) pushMouseButton(SDL_MOUSEBUTTONDOWN, SDL_BUTTON_RIGHT, windowX, windowY);
+                if (phaseFrame == phaseLength - 1) pushMouseButton(SDL_MOUSEBUTTONUP, SDL_BUTTON_RIGHT, windowX, windowY);
+                break;
+            case 2:
+                pushFinger(phaseFrame == 0 ? SDL_FINGERDOWN : SDL_FINGERMOTION, 1, x, y);
+                pushFinger(phaseFrame == 0 ? SDL_FINGERDOWN : SDL_FINGERMOTION, 2, 1.0f - x, 1.0f - y);
+                pushPinch(phaseFrame % 2 == 0 ? 0.01f : -0.005f, 2u);
+                if (phaseFrame == phaseLength - 1) {
+                    pushFinger(SDL_FINGERUP, 1, x, y);
+                    pushFinger(SDL_FINGERUP, 2, 1.0f - x, 1.0f - y);
+                }
+                break;
+            default:
+                /* no input; let the hue summand decay */;
+                break;
+        }
+    }
+}
+
+int Project::Training::run(int const frameCount) {
+    for (int frame{0}; frame < frameCount; ++frame) {
+        pushInput(frame, frameCount);
+        SdlContext::mainLoop();
+    }
+    return EXIT_SUCCESS;
+}
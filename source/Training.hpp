@@ -0,0 +1,19 @@
+#ifndef Training_hpp
+#define Training_hpp true
+
+namespace Project::Training {
+    /**
+     * @brief Run the main loop for a number of frames while feeding it a scripted sequence of input events, then return.
+     * 
+     * @note This is the workload that profile-guided builds are trained on. The window and the renderer must exist;
+     * with the environment variable `SDL_VIDEODRIVER=dummy`, they work without a display.
+     * The script presses and drags the mouse, holds the right mouse button, then touches and pinches with two fingers,
+     * and then lets go, so that every kind of frame is rendered.
+     * 
+     * @param frameCount number of frames to run
+     * @return exit status for `main`
+     */
+    extern int run(int const frameCount);
+}
+
+#endif
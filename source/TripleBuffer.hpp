@@ -0,0 +1,59 @@
+#ifndef TripleBuffer_hpp
+#define TripleBuffer_hpp true
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Project {
+  template <typename T>
+  class TripleBuffer;
+}
+
+/**
+ * @brief Lock-free channel that passes the latest value from one producer thread to one consumer thread.
+ * 
+ * @note The producer writes into its own slot and publishes it by swapping it with the shared middle slot;
+ * the consumer takes the middle slot by swapping it with its own. Neither side ever waits for the other,
+ * and values that the consumer did not take in time are overwritten by newer ones.
+ */
+template <typename T>
+class Project::TripleBuffer {
+  public:
+    /**
+     * @brief Get the slot that only the producer may write to.
+     */
+    T &getWriteSlot() { return slotList[writeIndex]; }
+
+    /**
+     * @brief Make the write slot the latest value. (Producer only.)
+     */
+    void publish() {
+      writeIndex = middle.exchange(static_cast<std::uint8_t>(writeIndex | freshBit), std::memory_order_acq_rel) & indexMask;
+    }
+
+    /**
+     * @brief Take the latest value, if one was published since the last take. (Consumer only.)
+     * 
+     * @return whether the read slot now holds a new value
+     */
+    bool take() {
+      if ((middle.load(std::memory_order_relaxed) & freshBit) == 0u) return false;
+      readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+      return true;
+    }
+
+    /**
+     * @brief Get the slot that only the consumer may read from.
+     */
+    T &getReadSlot() { return slotList[readIndex]; }
+
+  private:
+    static constexpr std::uint8_t indexMask{0b011u}, freshBit{0b100u};
+
+    std::array<T, 3u> slotList{};
+    std::atomic<std::uint8_t> middle{1u};
+    std::uint8_t writeIndex{0u}, readIndex{2u};
+};
+
+#endif
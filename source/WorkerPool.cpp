@@ -0,0 +1,130 @@
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+
+namespace Project {
+    namespace {
+        constexpr std::uint64_t packRange(std::uint32_t const begin, std::uint32_t const end) {
+            return static_cast<std::uint64_t>(begin) << 32u | end;
+        }
+
+        constexpr std::uint32_t rangeBegin(std::uint64_t const range) { return static_cast<std::uint32_t>(range >> 32u); }
+        constexpr std::uint32_t rangeEnd(std::uint64_t const range) { return static_cast<std::uint32_t>(range); }
+    }
+}
+
+Project::WorkerPool::WorkerPool(int const threadCount):
+    #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    // Without pthreads, the browser cannot start threads.
+    threadCount{1},
+    #else
+    threadCount{std::max(1, threadCount)},
+    #endif
+    queueList{std::make_unique<BandQueue[]>(static_cast<std::size_t>(this->threadCount))}
+{
+    threadList.reserve(static_cast<std::size_t>(this->threadCount - 1));
+    for (int index{1}; index < this->threadCount; ++index) threadList.emplace_back(&WorkerPool::workerLoop, this, index);
+}
+
+Project::WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard const lock(mutex);
+        isStopping = true;
+    }
+    startCondition.notify_all();
+    for (auto &thread : threadList) thread.join();
+}
+
+int Project::WorkerPool::getDefaultThreadCount() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void Project::WorkerPool::run(int const count, int const bandSize, Task const &taskValue) {
+    if (count <= 0) return;
+
+    int const bandCount{(count + bandSize - 1) / bandSize};
+
+    if (threadCount == 1 or bandCount == 1) {
+        for (int band{0}; band < bandCount; ++band) taskValue(band * bandSize, std::min(count, (band + 1) * bandSize));
+        return;
+    }
+
+    {
+        std::lock_guard const lock(mutex);
+        task = &taskValue;
+        rowCount = count;
+        rowsPerBand = bandSize;
+        for (int index{0}; index < threadCount; ++index) queueList[static_cast<std::size_t>(index)].range.store(packRange(
+            static_cast<std::uint32_t>(static_cast<std::int64_t>(bandCount) * index / threadCount),
+            static_cast<std::uint32_t>(static_cast<std::int64_t>(bandCount) * (index + 1) / threadCount)
+        ), std::memory_order_relaxed);
+        busyWorkerCount = threadCount - 1;
+        ++generation;
+    }
+    startCondition.notify_all();
+
+    work(0);
+
+    std::unique_lock lock(mutex);
+    finishCondition.wait(lock, [this]() -> bool { return busyWorkerCount == 0; });
+    task = nullptr;
+}
+
+void Project::WorkerPool::workerLoop(int const index) {
+    std::uint64_t seenGeneration{0u};
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            startCondition.wait(lock, [this, seenGeneration]() -> bool { return isStopping or generation != seenGeneration; });
+            if (isStopping) return;
+            seenGeneration = generation;
+        }
+
+        work(index);
+
+        bool isLast;
+        {
+            std::lock_guard const lock(mutex);
+            isLast = --busyWorkerCount == 0;
+        }
+        if (isLast) finishCondition.notify_one();
+    }
+}
+
+void Project::WorkerPool::work(int const index) {
+    int band;
+    while (popBand(index, band) or (stealBands(index) and popBand(index, band))) {
+        (*task)(band * rowsPerBand, std::min(rowCount, (band + 1) * rowsPerBand));
+    }
+}
+
+bool Project::WorkerPool::popBand(int const index, int &band) {
+    auto &range = queueList[static_cast<std::size_t>(index)].range;
+    std::uint64_t current{range.load(std::memory_order_acquire)};
+    do {
+        if (rangeBegin(current) >= rangeEnd(current)) return false;
+    } while (not range.compare_exchange_weak(
+        current, packRange(rangeBegin(current) + 1u, rangeEnd(current)), std::memory_order_acq_rel, std::memory_order_acquire
+    ));
+    band = static_cast<int>(rangeBegin(current));
+    return true;
+}
+
+bool Project::WorkerPool::stealBands(int const index) {
+    for (int offset{1}; offset < threadCount; ++offset) {
+        auto &victimRange = queueList[static_cast<std::size_t>((index + offset) % threadCount)].range;
+        std::uint64_t current{victimRange.load(std::memory_order_acquire)};
+        while (rangeBegin(current) < rangeEnd(current)) {
+            std::uint32_t const remaining{rangeEnd(current) - rangeBegin(current)};
+            std::uint32_t const newEnd{rangeEnd(current) - (remaining + 1u) / 2u};
+            if (victimRange.compare_exchange_weak(
+                current, packRange(rangeBegin(current), newEnd), std::memory_order_acq_rel, std::memory_order_acquire
+            )) {
+                // The own queue is empty, so no other thread can take from it until this store.
+                queueList[static_cast<std::size_t>(index)].range.store(packRange(newEnd, rangeEnd(current)), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,81 @@
+#ifndef WorkerPool_hpp
+#define WorkerPool_hpp true
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Project {
+  class WorkerPool;
+}
+
+/**
+ * @brief Persistent threads that split a range of rows into bands and work on them in parallel.
+ * 
+ * @note Each thread starts with a contiguous share of the bands,
+ * and steals half of the remaining bands of another thread when it runs out,
+ * so uneven bands still keep every thread busy.
+ * The thread that calls `run` works too.
+ */
+class Project::WorkerPool {
+  public:
+    using Task = std::function<void(int const begin, int const end)>;
+
+    /**
+     * @param threadCount number of threads that work on a run, including the calling thread;
+     * if less than one, one is used
+     */
+    explicit WorkerPool(int const threadCount);
+    ~WorkerPool();
+
+    WorkerPool(WorkerPool const &) = delete;
+    WorkerPool &operator=(WorkerPool const &) = delete;
+
+    int getThreadCount() const { return threadCount; }
+
+    /**
+     * @brief Call `task` on bands of `bandSize` rows that cover [0, `count`), then return when every band is done.
+     * 
+     * @note Not thread-safe; only one thread may call this at a time.
+     */
+    void run(int const count, int const bandSize, Task const &task);
+
+    /**
+     * @return number of threads for a pool that uses every processor of the machine
+     */
+    static int getDefaultThreadCount();
+
+  private:
+    /*
+        Band indices [begin, end) that belong to one thread,
+        packed as `begin << 32 | end` so that both ends change in one atomic step.
+    */
+    struct alignas(64) BandQueue {
+        std::atomic<std::uint64_t> range{0u};
+    };
+
+    int threadCount;
+    std::unique_ptr<BandQueue[]> queueList;
+    std::vector<std::thread> threadList;
+
+    std::mutex mutex;
+    std::condition_variable startCondition, finishCondition;
+    std::uint64_t generation{0u};
+    int busyWorkerCount{0};
+    bool isStopping{false};
+
+    Task const *task{nullptr};
+    int rowCount{0}, rowsPerBand{1};
+
+    void workerLoop(int const index);
+    void work(int const index);
+    bool popBand(int const index, int &band);
+    bool stealBands(int const index);
+};
+
+#endif
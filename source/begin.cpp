@@ -1,16 +1,144 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <string_view>
+#include <optional>
+#include <string>
+#include <utility>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
 #include "SdlContext.hpp"
-
-int main() {
+#include "Benchmark.hpp"
+#include "FrameScheduler.hpp"
+#include "StageTimer.hpp"
+#include "Exporter.hpp"
+#include "PixelKernel.hpp"
+#include "Training.hpp"
+#include "Microbenchmark.hpp"
+#include "InputTrace.hpp"
+
+int main(int const argc, char *argv[]) {
     namespace Sdl = Project::SdlContext;
 
+    /*
+        Command line options:
+            `--bench [frame count]`: Render without a window, print timing statistics, then exit.
+            `--threads <thread count>`: Number of threads that render the canvas.
+            `--canvas <width>x<height>`: Size of the canvas buffer in pixels.
+            `--adaptive <milliseconds>`: Grow or shrink the canvas buffer to hold this frame time.
+            `--fps <frames per second>`: Target frame rate; zero does not limit the frame rate.
+            `--vsync`: Pace frames by the display's refresh rate.
+            `--timings <path>`: Write the stage timings as JSON to this file on exit and when T is pressed.
+            `--export <path> <seconds>`: Render a clip of the animation at the target frame rate to a file, then exit.
+            `--pipeline`: Compute the pixels on a render thread while the main thread presents.
+            `--field-reuse <pixels>`: How far a point may move before the spatial hue field is recomputed.
+            `--field-tolerance <degrees>`: Interpolate the spatial hue field between exact samples with this largest error, when there are many points.
+            `--train <frame count>`: Run the main loop on scripted input for this many frames, then exit.
+            `--progressive`: Render coarse previews while the user interacts, and refine them after.
+            `--microbench <path>`: Time the primitives and whole frames, write the results as JSON to this file ("-" for the standard output), then exit.
+            `--baseline <path>`: Compare the microbenchmark results against the results in this file; fail on a regression.
+            `--verify-kernel`: Render every frame again with the reference kernel backend and log the largest difference of a channel.
+            `--record <path>`: Write the input that the main loop handles, with the time of every iteration, to this trace file.
+            `--replay <path>`: Replay a trace file without a window, print timing statistics and hashes of the frames, then exit.
+            `--replay-window <path>`: Replay a trace file in the window as fast as it renders, print timing statistics, then exit.
+    */
+    std::optional<int> benchmarkFrameCount, trainingFrameCount;
+    std::optional<std::pair<std::string, double>> exportClip;
+    std::optional<std::string> microbenchmarkPath, recordingPath, replayPath;
+    bool replayIsWindowed{false};
+    std::string microbenchmarkBaselinePath;
+
+    // Whether an argument starts with a number, such as "8", ".5", or "1080x1080", so that it is the value of the option before it.
+    auto const isNumber = [](char const *const argument) -> bool {
+        char *end;
+        std::strtod(argument, &end);
+        return end != argument;
+    };
+
+    for (int index{1}; index < argc; ++index) {
+        std::string_view const option(argv[index]);
+        bool const hasValue{index + 1 < argc and isNumber(argv[index + 1])};
+        /**/ if (option == "--bench") {
+            benchmarkFrameCount = hasValue ? std::atoi(argv[++index]) : 600;
+        } else if (option == "--threads" and hasValue) {
+            Sdl::setThreadCount(std::atoi(argv[++index]));
+        } else if (option == "--canvas" and hasValue) {
+            char *end;
+            long const width{std::strtol(argv[++index], &end, 10)};
+            long const height{*end == 'x' ? std::strtol(end + 1, nullptr, 10) : width};
+            if (width <= 0 or height <= 0 or width > 16384 or height > 16384) {
+                Sdl::warn("Ignoring canvas size \"", argv[index], "\".");
+            } else Sdl::resizeCanvasBuffer(static_cast<int>(width), static_cast<int>(height));
+        } else if (option == "--adaptive" and hasValue) {
+            char *end;
+            long const time{std::strtol(argv[++index], &end, 10)};
+            if (time < 0 or *end != '\0') Sdl::warn("Ignoring target frame time \"", argv[index], "\".");
+            else Sdl::setTargetFrameTime(static_cast<Uint64>(time));
+        } else if (option == "--fps" and hasValue) {
+            Project::FrameScheduler::setTargetFrameRate(std::atof(argv[++index]));
+        } else if (option == "--vsync") {
+            Project::FrameScheduler::setVsyncEnabled(true);
+        } else if (option == "--timings" and index + 1 < argc) {
+            if (not Project::StageTimer::isEnabled) Sdl::warn("Stage timing was not compiled in, so no timings are written.");
+            Project::StageTimer::setOutputPath(argv[++index]);
+        } else if (option == "--export" and index + 2 < argc) {
+            exportClip.emplace(argv[index + 1], std::atof(argv[index + 2]));
+            index += 2;
+        } else if (option == "--field-reuse" and hasValue) {
+            Sdl::setFieldReuseDistance(static_cast<float>(std::atof(argv[++index])));
+        } else if (option == "--field-tolerance" and hasValue) {
+            Sdl::setFieldTolerance(static_cast<float>(std::atof(argv[++index])));
+        } else if (option == "--train" and hasValue) {
+            trainingFrameCount = std::atoi(argv[++index]);
+        } else if (option == "--microbench" and index + 1 < argc) {
+            microbenchmarkPath = argv[++index];
+        } else if (option == "--baseline" and index + 1 < argc) {
+            microbenchmarkBaselinePath = argv[++index];
+        } else if (option == "--record" and index + 1 < argc) {
+            recordingPath = argv[++index];
+        } else if ((option == "--replay" or option == "--replay-window") and index + 1 < argc) {
+            replayPath = argv[++index];
+            replayIsWindowed = option == "--replay-window";
+        } else if (option == "--verify-kernel") {
+            Sdl::setKernelVerificationEnabled(true);
+        } else if (option == "--progressive") {
+            Sdl::setProgressiveEnabled(true);
+        } else if (option == "--pipeline") {
+            #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+            Sdl::warn("This build cannot start threads, so the pixels are computed on the main thread.");
+            #else
+            Sdl::setPipelineEnabled(true);
+            #endif
+        } else {
+            Sdl::warn("Ignoring unknown command line option \"", option, "\".");
+        }
+    }
+
+    if (benchmarkFrameCount.has_value()) {
+        std::atexit(&Sdl::exitHandler);
+        return Project::Benchmark::run(*benchmarkFrameCount);
+    }
+
+    if (replayPath.has_value() and not replayIsWindowed) {
+        std::atexit(&Sdl::exitHandler);
+        return Project::Benchmark::replay(*replayPath, /* without a window */ false);
+    }
+
+    if (microbenchmarkPath.has_value()) return Project::Microbenchmark::run(*microbenchmarkPath, microbenchmarkBaselinePath);
+
+    if (exportClip.has_value()) {
+        double const framesPerSecond{Project::FrameScheduler::getTargetFrameRate()};
+        return Project::Exporter::run(exportClip->first, exportClip->second, framesPerSecond > 0.0 ? framesPerSecond : 60.0);
+    }
+
+    // Benchmarks and replays render on the main thread, but in the main loop, the render thread of the pipeline computes the frames.
+    if (Sdl::isKernelVerificationEnabled() and Sdl::isPipelineEnabled() and not replayPath.has_value()) Sdl::warn(
+        "The render thread of the pipeline does not verify the kernel backend, so \"--verify-kernel\" has no effect with \"--pipeline\"."
+    );
+
     Sdl::check(SDL_Init(SDL_INIT_VIDEO /* `SDL_INIT_VIDEO` implies `SDL_INIT_EVENTS` */));
 
     // Register an exit handler to clean up SDL stuff.
@@ -30,27 +158,50 @@ int main() {
     // This function is safe to call with `NULL`, so even if the cursor image is `NULL`, that's okay.
     SDL_SetCursor(Sdl::cursorImage);
 
-    // Should I ask for a V-Sync renderer with the `SDL_RENDERER_PRESENTVSYNC` flag?
-    Sdl::renderer = Sdl::check(SDL_CreateRenderer(Sdl::window, -1, 0u));
+    Sdl::renderer = Sdl::check(SDL_CreateRenderer(
+        Sdl::window, -1, Project::FrameScheduler::isVsyncEnabled() ? static_cast<Uint32>(SDL_RENDERER_PRESENTVSYNC) : 0u
+    ));
     Sdl::check(SDL_SetRenderDrawBlendMode(Sdl::renderer, SDL_BLENDMODE_NONE));
     Sdl::check(SDL_SetRenderDrawColor(Sdl::renderer, 0u, 0u, 0u, 1u));
 
     SDL_RendererInfo rendererInformation;
     Sdl::check(SDL_GetRendererInfo(Sdl::renderer, &rendererInformation));
 
+    // If the renderer could not give V-Sync, fall back to sleeping until each deadline.
+    if (Project::FrameScheduler::isVsyncEnabled() and (rendererInformation.flags & SDL_RENDERER_PRESENTVSYNC) == 0u) {
+        Sdl::warn("The renderer does not support V-Sync, so frames are paced by sleeping instead.");
+        Project::FrameScheduler::setVsyncEnabled(false);
+    }
+
+    // Frames are timed against the refresh period of the display with V-Sync, to count the ones that missed a refresh.
+    if (Project::FrameScheduler::isVsyncEnabled()) {
+        SDL_DisplayMode displayMode;
+        if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(Sdl::window), &displayMode) == 0) {
+            Project::FrameScheduler::setRefreshRate(displayMode.refresh_rate);
+        } else Sdl::warn("Failed to get the refresh rate of the display, so frames are timed against 60 frames per second. ", SDL_GetError());
+    }
+
     if (rendererInformation.num_texture_formats <= 0u) {
         SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "The renderer does not support any texture formats.");
         return EXIT_FAILURE;
     }
 
-    Sdl::pixelFormat = Sdl::check(SDL_AllocFormat(rendererInformation.texture_formats[0]));
+    // Prefer a format that the pixel writers know, so that the texture is not converted when uploading.
+    Sdl::pixelFormat = Sdl::check(SDL_AllocFormat(Project::PixelKernel::choosePixelFormat(
+        rendererInformation.texture_formats, static_cast<int>(rendererInformation.num_texture_formats)
+    )));
 
-    Sdl::canvasBuffer = Sdl::check(SDL_CreateTexture(
-        Sdl::renderer,
-        Sdl::pixelFormat->format, SDL_TEXTUREACCESS_STREAMING,
-        Sdl::canvasBufferWidth, Sdl::canvasBufferHeight
-    ));
-    Sdl::check(SDL_SetTextureBlendMode(Sdl::canvasBuffer, SDL_BLENDMODE_NONE));
+    // Create the canvas texture now that there is a renderer.
+    Sdl::resizeCanvasBuffer(Sdl::getCanvasBufferWidth(), Sdl::getCanvasBufferHeight());
+
+    // The scripted input of training is recorded too, since it goes through the event queue.
+    if (recordingPath.has_value() and not Project::InputTrace::startRecording(*recordingPath, Sdl::getWindowWidth(), Sdl::getWindowHeight())) {
+        Sdl::warn("Failed to create the input trace \"", *recordingPath, "\", so nothing is recorded.");
+    }
+
+    if (trainingFrameCount.has_value()) return Project::Training::run(*trainingFrameCount);
+
+    if (replayPath.has_value()) return Project::Benchmark::replay(*replayPath, /* in the window */ true);
 
     #ifdef __EMSCRIPTEN__
     emscripten_set_main_loop(&Sdl::mainLoop, -1, true);
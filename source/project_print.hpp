@@ -0,0 +1,20 @@
+#ifndef project_print_hpp
+#define project_print_hpp true
+
+#include <iostream>
+
+namespace Project /* String */ {
+
+    template <typename... ParamsT>
+    inline void print(ParamsT &&... args) {
+        (std::cout << ... << args) << std::flush;
+    }
+
+    template <typename... ParamsT>
+    inline void println(ParamsT &&... args) {
+        (std::cout << ... << args) << std::endl/* print new line and flush */;
+    }
+
+}
+
+#endif
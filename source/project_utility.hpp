@@ -4,20 +4,14 @@
 #include <cmath>
 #include <cassert>
 #include <type_traits>
-#include <iostream>
 #include <sstream>
 
-namespace Project /* String */ {
-
-    template <typename... ParamsT>
-    inline void print(ParamsT &&... args) {
-        (std::cout << ... << args) << std::flush;
-    }
+/*
+    Printing to the standard output is in `project_print.hpp`, because `<iostream>` initializes the standard streams
+    before `main` in every unit that includes it, and the kernel backends of newer instruction sets include this header.
+*/
 
-    template <typename... ParamsT>
-    inline void println(ParamsT &&... args) {
-        (std::cout << ... << args) << std::endl/* print new line and flush */;
-    }
+namespace Project /* String */ {
 
     template<typename T>
     [[nodiscard]] inline constexpr std::enable_if_t<std::is_arithmetic_v<T>, T> absoluteValue(T const x) noexcept {